@@ -100,6 +100,50 @@ CPPLIB ?= stdc++
 LDLIBS = -lm -pthread
 LDFLAGS += $(shell wx-config --libs)
 
+#Multi-threaded model
+#THREADS=<n> verilates the design with <n> threads. The testbench is built
+#with VDB_SIM_THREADS, which protects the vdb components against DPI calls 
+#from the verilator worker threads and sets the default --sim-threads value.
+#Do a 'make clean' when switching between threaded and non-threaded builds.
+ifdef THREADS
+ifneq ($(THREADS),1)
+  VERILATE_FLAGS += --threads $(THREADS)
+  CXXFLAGS       += -DVDB_SIM_THREADS=$(THREADS)
+endif
+endif
+
+#Savable model
+#The design is verilated with --savable, so that the board can save and restore
+#checkpoints. Verilator doesn't support --savable for multi-threaded models.
+#SAVABLE=0 builds the model without save/restore support.
+SAVABLE ?= 1
+ifeq ($(SAVABLE),1)
+ifeq ($(filter --threads,$(VERILATE_FLAGS)),)
+  VERILATE_FLAGS += --savable
+  CXXFLAGS       += -DVDB_SAVABLE
+endif
+endif
+VERILATOR_CXX += $(VERILATOR_ROOT)/include/verilated_save.cpp
+
+#Sampled outputs
+#SAMPLED=1 compiles the DPI calls of the LED and 7-segment display out of
+#the design. The testbench samples their inputs from the model instead, see
+#the --sample option. Do a 'make clean' when switching.
+ifeq ($(SAMPLED),1)
+  DEFINES  += VDB_SAMPLED_OUTPUTS
+  CXXFLAGS += -DVDB_SAMPLED_OUTPUTS
+endif
+
+#Native VGA capture
+#NATIVE_VGA=1 removes the pixel clock and the frame buffer from the VGA 
+#monitor in the design. The testbench samples the VGA outputs from the
+#model and captures the frames in C++, see cVgaCapture. Do a 'make clean'
+#when switching.
+ifeq ($(NATIVE_VGA),1)
+  DEFINES  += VDB_NATIVE_VGA
+  CXXFLAGS += -DVDB_NATIVE_VGA
+endif
+
 ifdef PLI
 ifneq ($(PLI),"")
   PLI_OPTS = -pli $(PLI)
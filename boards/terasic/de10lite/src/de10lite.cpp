@@ -45,6 +45,11 @@
 
 #include <de10lite.hpp>
 
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <unistd.h>
+
 
 using namespace RoaLogic;
 using namespace common;
@@ -64,16 +69,26 @@ cDE10Lite::cDE10Lite(VerilatedContext* context, bool traceActive, cGuiInterface*
     /*
       define clocks
      */
-    clk_50  = addClock(_core->CLK_50, 20.0_ns);
-    clk2_50 = addClock(_core->CLK2_50, 20.0_ns);
-    clk_adc_10 = addClock(_core->CLOCK_ADC_10, 100.0_ns);
-    clk_vga = addClock(_core->de10lite_verilator_wrapper->vgaMonitor_inst->pixel_clk, 100.0_ns, false);
+    clk_50  = _scheduler.addClock(_core->CLK_50, 20.0_ns);
+    clk2_50 = _scheduler.addClock(_core->CLK2_50, 20.0_ns);
+    clk_adc_10 = _scheduler.addClock(_core->CLOCK_ADC_10, 100.0_ns);
+#ifdef VDB_NATIVE_VGA
+    clk_vga = _scheduler.addClock(_vgaPixelClk, 100.0_ns, false);
+#else
+    clk_vga = _scheduler.addClock(_core->de10lite_verilator_wrapper->vgaMonitor_inst->pixel_clk, 100.0_ns, false);
+#endif
 
     /*
       KEY
      */
     key = 0x3;        //KEY has pull-up
 
+    /*
+      Initial state checkpoint for a warm restart
+     */
+    _powerOnFile = (std::filesystem::temp_directory_path() / 
+                    ("de10lite_" + std::to_string(getpid()) + ".vlt")).string();
+
     // As last setup the GUI
     if(aGUI)
     {
@@ -86,10 +101,14 @@ cDE10Lite::cDE10Lite(VerilatedContext* context, bool traceActive, cGuiInterface*
  */
 cDE10Lite::~cDE10Lite()
 {
+    std::error_code error;
+
     if(_myGUI)
     {
         _myGUI->removeObserver(this);
     }
+
+    std::filesystem::remove(_powerOnFile, error);
 }
 
 void cDE10Lite::setupGUI()
@@ -99,8 +118,10 @@ void cDE10Lite::setupGUI()
 
     if(_myGUI)
     {
-        // First register ourself to the GUI so that we receive all the events from the GUI
-        _myGUI->registerObserver(this);
+        // First register ourself to the GUI so that we receive all the control events from the GUI
+        _myGUI->registerObserver(this, eventMask(eEvent::close, eEvent::reset, eEvent::stop, eEvent::stateChange,
+                                                 eEvent::step, eEvent::runFor, eEvent::runUntil, eEvent::fastForward,
+                                                 eEvent::saveCheckpoint, eEvent::restoreCheckpoint));
 
         // Setup the GUI itself
         _myGUI->setupGui("DE10lite virtual demo board",     // Name of the application
@@ -109,14 +130,12 @@ void cDE10Lite::setupGUI()
                     distanceSize(boardWidth, boardHeight),  // Size of the board
                     sRGBColor(0, 75, 128) );                // Background colour of the board
 
+        // Create the LED and 7-Segment display instances
+        createOutputs();
+
         // LEDs
         for(size_t i = 0; i < _cNumLed; i++)
         {
-            // Create a new led instance and map it through the scope with the verilated component
-            _ledInstances[i] = new cVdbLed("TOP.de10lite_verilator_wrapper.gen_vdbLED[" + 
-                                                std::to_string(i) + 
-                                                "].LED_inst", i);
-
             // Map the LED instance to a LED on the virtual board
             _myGUI->addVdbComponent(eVdbComponentType::vdbLed,                      // VDB component type LED
                                     _ledInstances[i],                               // Verilated linked component
@@ -128,11 +147,6 @@ void cDE10Lite::setupGUI()
         // 7-Segment Displays
         for(size_t i = 0; i < _cNum7Seg; i++)
         {
-            // Create a new 7 segment instance and map it through the scope with the verilated component
-            _7segInstances[i] = new cVdb7SegmentDisplay("TOP.de10lite_verilator_wrapper.gen_vdb7SegmentDisplay[" + 
-                                                std::to_string(i) + 
-                                                "].hex_inst", i);
-
             // Map the 7 segment instance to a 7 segment on the virtual board. The type of 7 segment is a commonAnode, with a RGB colour of pure RED.
             // The placement on the board is determined through the distancePoint.
             _myGUI->addVdbComponent(eVdbComponentType::vdb7SegmentDisplay,          // VDB component type 7 segment
@@ -202,9 +216,8 @@ void cDE10Lite::setupGUI()
                                 new sVdbConnectorInformation(eVdbConnectorType::DSUB,30.8_mm,16.2_mm,"VGA"),
                                 -90);                            // Rotate -90 degrees
 
-        // Create a new VGA instance and map it through the scope with the verilated component
-        _vgaController = new cVdbVGAMonitor("TOP.de10lite_verilator_wrapper.vgaMonitor_inst", this, clk_vga,
-                                            _core->de10lite_verilator_wrapper->vgaMonitor_inst->framebuffer);
+        // Create a new VGA instance
+        createVgaMonitor();
 
         // Create a new VGA component on the virtual board
         _myGUI->addVdbComponent(eVdbComponentType::vdbVGA,          // VDB component type VGA
@@ -214,84 +227,903 @@ void cDE10Lite::setupGUI()
     }
 }
 
+/**
+ * @brief Create the LED and 7-Segment display instances
+ * @details Each instance is mapped through the scope with the verilated 
+ * component. The instances are created for the GUI, or without a GUI when
+ * the outputs are recorded.
+ */
+void cDE10Lite::createOutputs()
+{
+    for(size_t i = 0; i < _cNumLed; i++)
+    {
+        if(!_ledInstances[i])
+        {
+            _ledInstances[i] = new cVdbLed("TOP.de10lite_verilator_wrapper.gen_vdbLED[" + 
+                                                std::to_string(i) + 
+                                                "].LED_inst", i, this);
+        }
+    }
+
+    for(size_t i = 0; i < _cNum7Seg; i++)
+    {
+        if(!_7segInstances[i])
+        {
+            _7segInstances[i] = new cVdb7SegmentDisplay("TOP.de10lite_verilator_wrapper.gen_vdb7SegmentDisplay[" + 
+                                                std::to_string(i) + 
+                                                "].hex_inst", i);
+        }
+    }
+}
+
+/**
+ * @brief Create the VGA monitor instance
+ * @details The instance is mapped through the scope with the verilated 
+ * component. It is created for the GUI, or without a GUI when the frames 
+ * are written into files.
+ */
+void cDE10Lite::createVgaMonitor()
+{
+    if(_vgaController)
+    {
+        return;
+    }
+
+#ifdef VDB_NATIVE_VGA
+    _vgaController = new cVdbVGAMonitor("TOP.de10lite_verilator_wrapper.vgaMonitor_inst", this, clk_vga);
+
+    if(_vgaOnDesignClock)
+    {
+        _vgaController->sampleOnDesignClock(_vgaDivider);
+    }
+#else
+    _vgaController = new cVdbVGAMonitor("TOP.de10lite_verilator_wrapper.vgaMonitor_inst", this, clk_vga,
+                                        _core->de10lite_verilator_wrapper->vgaMonitor_inst->framebuffer);
+#endif
+}
+
 /**
  * @brief Generate reset
- * @details This is a coroutine function that generates the main reset
+ * @details This is a task that generates the main reset
  * 
  * It is generates the first reset after 5 clock cycles. Following that
- * it is suspended until a resume() is called on it. This is done so that
- * in a running design another reset could be triggered in the system. 
+ * it waits for the reset trigger. This is done so that in a running 
+ * design another reset could be triggered in the system. 
+ * 
+ * When the board is restored from a checkpoint the design is already out
+ * of reset, the first reset is then skipped.
  * 
  * No processing power is used when the reset function is in a suspended state.
  * 
- * @return The coroutine handle for this function
+ * @param[in] initialReset  Generate the first reset
+ * 
+ * @return The task for this function
  */
-sCoRoutineHandler<bool> cDE10Lite::Reset()
+cTask cDE10Lite::Reset(bool initialReset)
 {
-    INFO << "Resetting FPGA\n";
-
     //KEY[0] is used as asynchronous active low signal
 
-    //wait a while
-    for (uint8_t i=0; i<5; i++)
+    if(initialReset)
+    {
+        INFO << "Resetting FPGA\n";
+
+        //wait a while
+        for (uint8_t i=0; i<5; i++)
+        {
+            co_await clk_50->posEdge();
+        }
+    }
+    else
     {
-        waitPosEdge(clk_50);
+        co_await _resetTrigger;
     }
 
-    do
+    while (!finished())
     {
         INFO << "Assert reset\n";
         bitClr8(key,0);
-        waitPosEdge(clk_50);
+        co_await clk_50->posEdge();
 
         INFO << "Negate reset\n";
         bitSet8(key,0);
-        co_await std::suspend_always{};
-    } while (!finished());
+        co_await _resetTrigger;
+    }
+}
+
+
+/**
+ * @brief Advance the design to the next clock edge
+ * @details The edge scheduler toggles all clocks with an edge at the next
+ * edge time, after which the design is evaluated once. Tasks waiting for 
+ * one of these edges, or for this time, are resumed after the evaluation.
+ * 
+ * With VDB_NATIVE_VGA a rising edge of the VGA pixel clock, or of CLK_50 
+ * with setVgaDivider(), passes the VGA outputs to the VGA monitor before the
+ * evaluation, so that the outputs before the edge are used.
+ */
+void cDE10Lite::tick()
+{
+    if(_scheduler.advance())
+    {
+        VerilatedContext* context = _core->contextp();
+
+#ifdef VDB_NATIVE_VGA
+        const uint8_t vgaClk = _vgaOnDesignClock ? _core->CLK_50 : _vgaPixelClk;
+
+        if(vgaClk != _vgaClkDelayed)
+        {
+            _vgaClkDelayed = vgaClk;
+
+            if(vgaClk && _vgaController)
+            {
+                captureVgaPixel();
+            }
+        }
+#endif
+
+        context->time(_scheduler.getContextTime(context));
+        _core->eval();
+
+#ifdef VDB_SAMPLED_OUTPUTS
+        if(_sampleTimeBased && getTime() >= _nextSample)
+        {
+            sampleOutputs();
+        }
+#endif
+
+        // Commit the last output values of this time step
+        cVDBCommon::commitPending(getTime());
+
+        if(_trace)
+        {
+            _trace->dump(context->time());
+        }
+
+        _scheduler.resumeWaiters();
+    }
+}
+
+/**
+ * @brief Capture a VGA pixel
+ * @details Passes the VGA outputs of the design to the VGA monitor, the 
+ * 4 bit colours are extended to 8 bits the same way as for the verilog 
+ * VGA monitor. Only used with VDB_NATIVE_VGA.
+ */
+void cDE10Lite::captureVgaPixel()
+{
+#ifdef VDB_NATIVE_VGA
+    const auto* wrapper = _core->de10lite_verilator_wrapper;
+
+    if(_vgaOnDesignClock)
+    {
+        _vgaController->designClock(wrapper->vga_r << 4, wrapper->vga_g << 4, wrapper->vga_b << 4,
+                                    wrapper->vga_hsync, wrapper->vga_vsync);
+    }
+    else
+    {
+        _vgaController->clock(wrapper->vga_r << 4, wrapper->vga_g << 4, wrapper->vga_b << 4,
+                              wrapper->vga_hsync, wrapper->vga_vsync);
+    }
+#endif
+}
+
+/**
+ * @brief Sample the VGA outputs on CLK_50
+ * @details The VGA outputs are sampled on every divider-th rising edge of 
+ * CLK_50, without a separate pixel clock. Only possible with VDB_NATIVE_VGA,
+ * and when the design generates the VGA timing from CLK_50.
+ * 
+ * @param[in] divider   CLK_50 cycles per pixel, 0 detects the divider from 
+ *                      the horizontal timing
+ */
+void cDE10Lite::setVgaDivider(uint32_t divider)
+{
+#ifdef VDB_NATIVE_VGA
+    _vgaOnDesignClock = true;
+    _vgaDivider = divider;
+    _vgaClkDelayed = _core->CLK_50;
+
+    if(_vgaController)
+    {
+        _vgaController->sampleOnDesignClock(divider);
+    }
+#else
+    (void)divider;
+#endif
+}
+
+/**
+ * @brief Get the simulation time
+ * @details The time is kept by the edge scheduler
+ */
+simtime_t cDE10Lite::getTime()
+{
+    return _scheduler.getTime();
+}
+
+/**
+ * @brief Run a quantum of ticks
+ * @details Runs the design for the number of ticks (and optionally the 
+ * simulation time) of the tick quantum, without checking the run control.
+ * 
+ * When a step or run until command is active the limit is checked every
+ * tick, so that the design pauses exactly at the requested point. Rising 
+ * edges of CLK_50 are used as reference for the step command. During a 
+ * fast forward the quantum ends at the target time.
+ * 
+ * @return The number of ticks executed
+ */
+uint32_t cDE10Lite::runQuantum()
+{
+    const uint32_t maxTicks = _tickQuantum.getTicks();
+    uint32_t ticks = 0;
+
+    if(_runControl.hasLimit())
+    {
+        while(ticks < maxTicks && _runControl.isRunning())
+        {
+            bool clkLow = !_core->CLK_50;
+            tick();
+            ticks++;
+
+            _runControl.update(getTime(), clkLow && _core->CLK_50);
+        }
+    }
+    else if(_fastForward)
+    {
+        while(ticks < maxTicks && getTime() < _fastForwardUntil)
+        {
+            tick();
+            ticks++;
+        }
+    }
+    else if(_tickQuantum.isTimeBased())
+    {
+        simtime_t endTime = getTime() + _tickQuantum.getTime();
+
+        while(ticks < maxTicks && getTime() < endTime)
+        {
+            tick();
+            ticks++;
+        }
+    }
+    else
+    {
+        for(; ticks < maxTicks; ticks++)
+        {
+            tick();
+        }
+    }
+
+    return ticks;
+}
+
+/**
+ * @brief Show the simulation speed
+ * @details Shows the achieved ratio between simulation time and wall
+ * clock time in the status bar, or in the log when there is no GUI.
+ */
+void cDE10Lite::showSpeed()
+{
+    std::ostringstream text;
+
+    text << std::setprecision(3) << "Speed: " << _pacer.getAchievedRatio() << "x real time";
+
+    if(_pacer.isEnabled())
+    {
+        text << " (paced at " << _pacer.getRatio() << "x)";
+    }
+
+    if(_myGUI)
+    {
+        _myGUI->setStatusText(text.str());
+    }
+    else
+    {
+        INFO << text.str() << "\n";
+    }
+}
 
-    co_return true;    
+/**
+ * @brief Show the run state on the GUI
+ * @details The run state is changed by the GUI, but also by the run 
+ * control itself when a step, run for or run until command completes.
+ * The GUI is only told when the state changed since the last call.
+ * 
+ * @note Shall be called from the verilator thread, once per loop
+ */
+void cDE10Lite::showRunState()
+{
+    eSystemState state = _runControl.getState();
+
+    if(_myGUI && state != _shownState)
+    {
+        _myGUI->setRunState(state);
+    }
+
+    _shownState = state;
 }
 
+/**
+ * @brief Start a fast forward
+ * @details Suspends the notifications of all vdb components until the
+ * target time is reached. This also stops the VGA capture. 
+ * 
+ * @param[in] time  The simulation time to fast forward to
+ */
+void cDE10Lite::beginFastForward(simtime_t time)
+{
+    INFO << "Fast forward to " << time.ms() << "ms\n";
+
+    _fastForward = true;
+    _fastForwardUntil = time;
+    cVDBCommon::suspendNotifications();
+}
+
+/**
+ * @brief End a fast forward
+ * @details Resumes the notifications, every vdb component resyncs
+ * its GUI component with the current state in one pass.
+ */
+void cDE10Lite::endFastForward()
+{
+    INFO << "Fast forward ended at " << getTime().ms() << "ms\n";
+
+    _fastForward = false;
+    cVDBCommon::resumeNotifications();
+    _pacer.restart();
+}
+
+/**
+ * @brief Save a checkpoint
+ * @details Saves the verilated model, the edge scheduler and the state 
+ * of the vdb components into a file. The model must be verilated with
+ * --savable, see SAVABLE in build.mk. The file starts with the number
+ * of scheduler clocks, so a restore can reject it before the model is
+ * overwritten.
+ * 
+ * @note Shall be called from the verilator thread, between two ticks
+ * 
+ * @param[in] fileName  The checkpoint file
+ * 
+ * @return true when the checkpoint is saved
+ */
+bool cDE10Lite::saveCheckpoint(std::string fileName)
+{
+#ifdef VDB_SAVABLE
+    VerilatedSave os;
+    uint64_t numClocks = _scheduler.getNumClocks();
+    bool present = false;
+
+    os.open(fileName.c_str());
+
+    if(!os.isOpen())
+    {
+        ERROR << "Can't open checkpoint file " << fileName << "\n";
+        return false;
+    }
+
+    os << numClocks;
+    os << *_core;
+    _scheduler.save(os);
+
+#ifdef VDB_NATIVE_VGA
+    // The VGA pixel clock isn't part of the model
+    os << _vgaPixelClk;
+#endif
+
+    // The vdb components are created by the GUI, a recording or a VGA
+    // dump, each one is preceded by a presence flag
+    for(cVdbLed* led : _ledInstances)
+    {
+        present = led != nullptr;
+        os << present;
+
+        if(present)
+        {
+            led->saveState(os);
+        }
+    }
+
+    for(cVdb7SegmentDisplay* display : _7segInstances)
+    {
+        present = display != nullptr;
+        os << present;
+
+        if(present)
+        {
+            display->saveState(os);
+        }
+    }
+
+    present = _vgaController != nullptr;
+    os << present;
+
+    if(present)
+    {
+        _vgaController->saveState(os);
+    }
+
+    os.close();
+    INFO << "Checkpoint at " << getTime().ms() << "ms saved to " << fileName << "\n";
+
+    return true;
+#else
+    WARNING << "Model is not savable, rebuild with SAVABLE=1 to use checkpoints\n";
+    return false;
+#endif
+}
+
+/**
+ * @brief Restore a checkpoint
+ * @details Restores the verilated model, the edge scheduler and the state 
+ * of the vdb components from a file, after which the GUI components are 
+ * resynced. The vdb components that are saved in the checkpoint are
+ * created when they don't exist yet. When the checkpoint is restored 
+ * before the board runs, the first reset is skipped.
+ * 
+ * @note Shall be called from the verilator thread, between two ticks
+ * 
+ * @param[in] fileName  The checkpoint file
+ * 
+ * @return true when the checkpoint is restored
+ */
+bool cDE10Lite::restoreCheckpoint(std::string fileName)
+{
+#ifdef VDB_SAVABLE
+    VerilatedRestore os;
+    uint64_t numClocks = 0;
+    bool present = false;
+
+    os.open(fileName.c_str());
+
+    if(!os.isOpen())
+    {
+        ERROR << "Can't open checkpoint file " << fileName << "\n";
+        return false;
+    }
+
+    // Check the header before anything of the board is overwritten
+    os >> numClocks;
+
+    if(numClocks != _scheduler.getNumClocks())
+    {
+        ERROR << "Checkpoint " << fileName << " doesn't match the clocks of this board\n";
+        os.close();
+        return false;
+    }
+
+    os >> *_core;
+    _scheduler.restore(os);
+
+#ifdef VDB_NATIVE_VGA
+    os >> _vgaPixelClk;
+    _vgaClkDelayed = _vgaOnDesignClock ? _core->CLK_50 : _vgaPixelClk;
+#endif
+
+    // A component saved in the checkpoint is created when it doesn't
+    // exist yet, a component that isn't saved keeps its state
+    for(size_t i = 0; i < _cNumLed; i++)
+    {
+        os >> present;
+
+        if(present)
+        {
+            createOutputs();
+            _ledInstances[i]->restoreState(os);
+        }
+    }
+
+    for(size_t i = 0; i < _cNum7Seg; i++)
+    {
+        os >> present;
+
+        if(present)
+        {
+            createOutputs();
+            _7segInstances[i]->restoreState(os);
+        }
+    }
+
+    os >> present;
+
+    if(present)
+    {
+        createVgaMonitor();
+        _vgaController->restoreState(os);
+    }
+
+    os.close();
+
+    _core->contextp()->time(_scheduler.getContextTime(_core->contextp()));
+    _skipInitialReset = true;
+    _nextSample = getTime();
+    _pacer.restart();
+
+    if(!cVDBCommon::notificationsSuspended())
+    {
+        cVDBCommon::resyncObservers();
+    }
+
+    INFO << "Checkpoint at " << getTime().ms() << "ms restored from " << fileName << "\n";
+
+    return true;
+#else
+    WARNING << "Model is not savable, rebuild with SAVABLE=1 to use checkpoints\n";
+    return false;
+#endif
+}
+
+/**
+ * @brief Save a checkpoint at a simulation time
+ * @details The checkpoint is saved at the end of the first tick quantum 
+ * that reaches the time, the checkpoint holds the exact time it was saved.
+ * 
+ * @param[in] time      The simulation time
+ * @param[in] fileName  The checkpoint file
+ */
+void cDE10Lite::saveAt(simtime_t time, std::string fileName)
+{
+    _saveAtPending = true;
+    _saveAtTime = time;
+    _saveAtFile = fileName;
+}
+
+/**
+ * @brief Save the pending checkpoint when its time is reached
+ */
+void cDE10Lite::checkSaveAt()
+{
+    if(_saveAtPending && getTime() >= _saveAtTime)
+    {
+        _saveAtPending = false;
+        saveCheckpoint(_saveAtFile);
+    }
+}
+
+/**
+ * @brief Refresh the brightness of the LEDs
+ * @details Closes the display interval of each LED when it has ended, so 
+ * that a LED without edges is updated as well. Called between quanta.
+ */
+void cDE10Lite::refreshLeds()
+{
+    for(cVdbLed* led : _ledInstances)
+    {
+        if(led)
+        {
+            led->refresh();
+        }
+    }
+}
+
+/**
+ * @brief Set the sample interval of the outputs
+ * @details Only used when the design is built with VDB_SAMPLED_OUTPUTS, see
+ * SAMPLED in build.mk. The LED and 7-segment display inputs are then read 
+ * from the model every interval of simulation time. With an interval of 0 
+ * they are read after every tick quantum, i.e. once per GUI update.
+ * 
+ * @param[in] interval  The simulation time between two samples
+ */
+void cDE10Lite::setSampleInterval(simtime_t interval)
+{
+    _sampleInterval = interval;
+    _sampleTimeBased = interval.ms() > 0;
+    _nextSample = getTime();
+}
+
+/**
+ * @brief Sample the outputs of the design
+ * @details Reads the LED and 7-segment display inputs from the model and 
+ * passes them to the vdb components, which only notify their observers 
+ * when a value changed. Without VDB_SAMPLED_OUTPUTS the components are 
+ * updated through the DPI functions and nothing is sampled.
+ */
+void cDE10Lite::sampleOutputs()
+{
+#ifdef VDB_SAMPLED_OUTPUTS
+    const uint16_t ledr = _core->de10lite_verilator_wrapper->ledr;
+
+    for(size_t i = 0; i < _cNumLed; i++)
+    {
+        if(_ledInstances[i])
+        {
+            _ledInstances[i]->sample((ledr >> i) & 1);
+        }
+    }
+
+    for(size_t i = 0; i < _cNum7Seg; i++)
+    {
+        if(_7segInstances[i])
+        {
+            _7segInstances[i]->sample(_core->de10lite_verilator_wrapper->hex[i]);
+        }
+    }
+#endif
+
+    _nextSample = getTime() + _sampleInterval;
+}
+
+/**
+ * @brief Record the outputs of the board
+ * @details The events of the LEDs and 7-Segment displays are recorded into
+ * a file, which can be played back with replay(). The VGA monitor is not 
+ * recorded. Without a GUI the LED and 7-Segment display instances are 
+ * created for the recording.
+ * 
+ * @param[in] fileName  The file to record to
+ * 
+ * @return true when the recording is started
+ */
+bool cDE10Lite::record(std::string fileName)
+{
+    if(!_myGUI)
+    {
+        createOutputs();
+    }
+
+    _recorder = std::make_unique<cVdbRecorder>(this);
+
+    if(!_recorder->open(fileName))
+    {
+        _recorder.reset();
+        return false;
+    }
+
+    // The channels of the replay are attached in the same order
+    for(cVdbLed* led : _ledInstances)
+    {
+        _recorder->attach(led);
+    }
+
+    for(cVdb7SegmentDisplay* display : _7segInstances)
+    {
+        _recorder->attach(display);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write the VGA frames into files
+ * @details The frames from the first up to the last frame, and every n-th
+ * frame in between, are written by a cVgaFrameSink. A file name ending with
+ * .y4m writes one YUV4MPEG2 stream, otherwise a PPM file is written per 
+ * frame. Without a GUI the VGA monitor is created for the sink.
+ * 
+ * @param[in] fileName  The stream, or the base name of the frame files
+ * @param[in] first     First written frame
+ * @param[in] last      Last written frame
+ * @param[in] every     Write every n-th frame from the first frame on
+ * 
+ * @return true when the sink is opened
+ */
+bool cDE10Lite::dumpVga(std::string fileName, uint32_t first, uint32_t last, uint32_t every)
+{
+    createVgaMonitor();
+
+    _frameSink = std::make_unique<cVgaFrameSink>();
+
+    if(!_frameSink->open(fileName, first, last, every))
+    {
+        _frameSink.reset();
+        return false;
+    }
+
+    _frameSink->attach(_vgaController);
+
+    return true;
+}
+
+/**
+ * @brief Close the VGA frame sink after its last frame
+ * @details The sink can't detach itself within the notification of the
+ * VGA monitor, so this is done here. Without other observers the monitor
+ * then stops capturing.
+ * 
+ * @note Shall be called from the verilator thread, between two ticks
+ */
+void cDE10Lite::checkFrameSink()
+{
+    if(_frameSink && _frameSink->isDone())
+    {
+        _frameSink.reset();
+    }
+}
+
+/**
+ * @brief Execute a checkpoint action requested through the run control
+ */
+void cDE10Lite::handleCheckpoint()
+{
+    cRunControl::eCheckpointAction action;
+    std::string fileName;
+
+    if(_runControl.takeCheckpoint(action, fileName))
+    {
+        if(action == cRunControl::eCheckpointAction::save)
+        {
+            saveCheckpoint(fileName);
+        }
+        else
+        {
+            restoreCheckpoint(fileName);
+        }
+    }
+}
+
+/**
+ * @brief Restart the board in place
+ * @details Restores the checkpoint of the initial state, the verilated 
+ * model, the vdb components and the GUI components are kept. When the 
+ * initial state is before the first reset, the reset is generated again.
+ */
+void cDE10Lite::warmRestart()
+{
+    INFO << "Restarting FPGA\n";
+
+    if(_fastForward)
+    {
+        endFastForward();
+    }
+
+    if(restoreCheckpoint(_powerOnFile) && _powerOnReset)
+    {
+        _resetTrigger.fire();
+    }
+}
 
 /**
  * @brief Run testbench
- *
+ * @details Runs the testbench under control of the GUI
+ * 
+ * The run control determines when the design may run. When the design is
+ * not running the thread blocks inside the run control, until it is started
+ * again, a reset is requested or the simulation ends. 
+ * 
+ * While running, the run control is only checked between quanta of ticks,
+ * see cTickQuantum. A finish from the design is therefore also noticed at
+ * the end of a quantum. After each quantum the pacer can lock the simulation
+ * to the wall clock, see cPacer.
+ * 
+ * A fast forward runs unpaced with the notifications of the vdb components
+ * suspended, until the target time is reached or the simulation is paused.
+ * 
+ * Checkpoint actions are executed between quanta, also when paused.
+ * 
+ * With a savable model the initial state is saved first. A stop then 
+ * restores this state in place, instead of rebuilding the board.
  */
 eRunState cDE10Lite::run()
 {
+#ifdef VDB_SAVABLE
+    //Save the initial state for a warm restart
+    _powerOnReset = !_skipInitialReset;
+    _warmRestart = saveCheckpoint(_powerOnFile);
+#endif
+
     //Reset core
-    sCoRoutineHandler reset = Reset();
+    _tasks.spawn(Reset(!_skipInitialReset));
 
     //Run testbench
     while(!finished())
     {
-        if(_myState == eSystemState::running)
+        simtime_t fastForwardTime;
+
+        showRunState();
+
+        if(_runControl.takeReset())
         {
-            tick();
+            _resetTrigger.fire();
+        }
+
+        if(_runControl.takeRestart())
+        {
+            warmRestart();
+        }
+
+        handleCheckpoint();
+
+        if(_runControl.takeFastForward(fastForwardTime))
+        {
+            beginFastForward(fastForwardTime);
+        }
+
+        if(!_runControl.isRunning())
+        {
+            if(_fastForward)
+            {
+                endFastForward();
+            }
+
+            _runControl.waitForRun(getTime());
+            _pacer.restart();
+            continue;
+        }
+
+        _tickQuantum.begin();
+        _tickQuantum.end(runQuantum());
+
+        checkSaveAt();
+
+#ifdef VDB_SAMPLED_OUTPUTS
+        if(!_sampleTimeBased)
+        {
+            sampleOutputs();
+            cVDBCommon::commitPending(getTime());
         }
+#endif
 
-        if(doReset)
+        refreshLeds();
+        checkFrameSink();
+
+        if(_fastForward)
+        {
+            if(getTime() >= _fastForwardUntil)
+            {
+                endFastForward();
+            }
+        }
+        else
+        {
+            // Wait in bounded steps, a pending command ends the wait
+            while(!_pacer.pace(getTime()) && !_runControl.hasPendingCommand());
+        }
+
+        if(_pacer.measure(getTime()))
         {
-            reset.resume();
-            doReset = false;
+            showSpeed();
         }
     }
 
-    reset.resume(); // End the reset coroutine at this point
+    if(_fastForward)
+    {
+        endFastForward();
+    }
+
+    _tasks.clear(); // End all tasks at this point
     INFO << "Simulation ended\n";
+    _tickQuantum.report(getTime());
+    cVDBCommon::reportFilter();
+    _recorder.reset();
+    _frameSink.reset();
 
     return _returnState;
 }
 
 eRunState cDE10Lite::run(uint32_t numMilliSeconds)
 {
+    simtime_t fastForwardTime;
+
     //Reset core
-    sCoRoutineHandler reset = Reset();
+    _tasks.spawn(Reset(!_skipInitialReset));
+
+    //Skip the recording and the VGA dump until the fast forward time
+    if(_runControl.takeFastForward(fastForwardTime))
+    {
+        beginFastForward(fastForwardTime);
+    }
 
     //Run testbench
     while(!finished())
     {
         tick();
+        checkSaveAt();
+
+        if(_fastForward && getTime() >= _fastForwardUntil)
+        {
+            endFastForward();
+        }
+
+        // Without a GUI the LEDs are only refreshed for the recording
+        if(_recorder && getTime() >= _nextRefresh)
+        {
+            refreshLeds();
+            _nextRefresh = getTime() + simtime_t(cVdbLed::cDefaultInterval);
+        }
+
+        checkFrameSink();
 
         if(numMilliSeconds != 0)
         {
@@ -303,47 +1135,175 @@ eRunState cDE10Lite::run(uint32_t numMilliSeconds)
         }
     }
 
-    reset.resume(); // End the reset coroutine at this point
+    if(_fastForward)
+    {
+        endFastForward();
+    }
+
+    _tasks.clear(); // End all tasks at this point
     INFO << "Simulation ended\n";
+    cVDBCommon::reportFilter();
+    _recorder.reset();
+    _frameSink.reset();
 
     return _returnState;
 
 }
 
+/**
+ * @brief Replay a recording
+ * @details Plays back a recording of record() on the GUI, the verilated 
+ * model is not evaluated. The components are attached in the same order 
+ * as for the recording. 
+ * 
+ * The replay follows the run control, and is locked to the wall clock with 
+ * the pacer. Without pacing the recording is played back as fast as 
+ * possible. At the end of the recording the replay is paused and the GUI 
+ * keeps the last state, until it is closed or stopped. A reset, restart, 
+ * fast forward or checkpoint request has no meaning for a recording and is 
+ * ignored. A run for or run until pauses at the recorded time, a step has 
+ * no cycles to count and runs freely.
+ * 
+ * A gap in the recording can be long at a slow ratio. The next record is 
+ * therefore kept until the pacer reaches its time, and the run control is 
+ * checked between the bounded waits of the pacer.
+ * 
+ * @note The board still constructs the verilated model, it is only never
+ * evaluated. The VGA monitor is attached to its scope, while the LEDs and
+ * 7-segment displays are dispatched by ID and don't need the model.
+ * 
+ * @param[in] fileName  The recording
+ */
+eRunState cDE10Lite::replay(std::string fileName)
+{
+    cVdbReplay recording;
+    sVdbRecord record;
+    simtime_t time;
+    simtime_t recordTime;
+    bool recordPending = false;
+    bool ended = false;
+
+    if(!recording.open(fileName))
+    {
+        return eRunState::completed;
+    }
+
+    for(cVdbLed* led : _ledInstances)
+    {
+        recording.attach(led);
+    }
+
+    for(cVdb7SegmentDisplay* display : _7segInstances)
+    {
+        recording.attach(display);
+    }
+
+    INFO << "Replaying " << fileName << "\n";
+
+    while(!finished())
+    {
+        cRunControl::eCheckpointAction action;
+        std::string checkpointFile;
+        simtime_t fastForwardTime;
+
+        showRunState();
+
+        // These requests would wake up the run control forever
+        if(_runControl.takeReset() | _runControl.takeRestart() | 
+           _runControl.takeFastForward(fastForwardTime) |
+           _runControl.takeCheckpoint(action, checkpointFile))
+        {
+            WARNING << "Reset, restart, fast forward and checkpoints are not available during a replay\n";
+        }
+
+        if(_runControl.hasLimit())
+        {
+            _runControl.update(time, false);
+        }
+
+        if(!_runControl.isRunning())
+        {
+            _runControl.waitForRun(time);
+            _pacer.restart();
+            continue;
+        }
+
+        if(!recordPending)
+        {
+            if(!recording.read(record))
+            {
+                if(!ended)
+                {
+                    INFO << "Replay ended at " << time.ms() << "ms\n";
+                    ended = true;
+                }
+
+                // The end of the recording pauses the replay, the run 
+                // control then blocks until the GUI is stopped or closed
+                _runControl.pause();
+                continue;
+            }
+
+            recordTime = cVdbReplay::getTime(record);
+            recordPending = true;
+        }
+
+        if(!_pacer.pace(recordTime))
+        {
+            continue;
+        }
+
+        time = recordTime;
+        recording.apply(record);
+        recordPending = false;
+
+        if(_pacer.measure(time))
+        {
+            showSpeed();
+        }
+    }
+
+    return _returnState;
+}
+
+/**
+ * @brief Handle GUI events
+ * @details Close ends the simulation. Stop restarts the board in place
+ * when the initial state is saved, otherwise the GUI components are 
+ * removed and the simulation ends, so that main() rebuilds the board.
+ * All other events are passed to the run control.
+ * 
+ * @note This function runs in the GUI thread
+ */
 void cDE10Lite::notify(eEvent aEvent, void* data)
 {
     switch(aEvent)
     {
         case eEvent::close:
             finish();
+            _runControl.terminate();
         break;
 
         case eEvent::stop:
-            _returnState = eRunState::restart;
-            finish();
-        break;
-
-        case eEvent::reset:
-            doReset = true;
-            break;
-
-        case eEvent::stateChange:
-            switch (_myState)
+            if(_warmRestart)
             {
-            case eSystemState::paused :
-                [[fallthrough]];
-            case eSystemState::idle :
-                _myState = eSystemState::running;
-                break;
-            case eSystemState::running:
-                [[fallthrough]];
-            default:
-                _myState = eSystemState::paused;
-                break;
+                _runControl.restart();
+            }
+            else
+            {
+                if(_myGUI)
+                {
+                    _myGUI->removeVdbComponents();
+                }
+
+                _returnState = eRunState::restart;
+                finish();
+                _runControl.terminate();
             }
         break;
 
         default:
+            _runControl.handleEvent(aEvent, data);
             break;
     }
 }
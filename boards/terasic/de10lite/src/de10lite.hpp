@@ -53,6 +53,13 @@
 #include <testbench.hpp>
 
 #include "gui_interface.hpp"
+#include "runControl.hpp"
+#include "tickQuantum.hpp"
+#include "pacer.hpp"
+#include "taskPool.hpp"
+#include "edgeScheduler.hpp"
+#include "vdbRecorder.hpp"
+#include "vgaFrameSink.hpp"
 
 //model header, generated by verilator
 #include "Vde10lite_verilator_wrapper.h"
@@ -75,6 +82,9 @@ using namespace clock;
 using namespace GUI;
 using namespace observer;
 using namespace vdb;
+using namespace control;
+using namespace scheduler;
+using namespace recorder;
 
 enum class eRunState
 {
@@ -95,7 +105,18 @@ enum class eRunState
  * high level connections and how to control the DUT. Tests can be added and run without the context 
  * of this class. 
  * 
- * It is derived from the cTestBench to have a general testbench control
+ * It is derived from the cTestBench to have a general testbench control. The clocks
+ * are driven by a cEdgeScheduler, tick() jumps to the next clock edge, toggles all 
+ * clocks with an edge at that time and evaluates the design once.
+ * 
+ * Stimulus and monitors are written as cTask coroutines, which are spawned in the
+ * _tasks pool and wait for clock edges, delays or triggers.
+ * 
+ * With VDB_NATIVE_VGA the VGA pixel clock isn't part of the design, it drives
+ * _vgaPixelClk instead. On each rising edge the VGA outputs are passed to the
+ * VGA monitor, which captures the frames in C++. With setVgaDivider() the 
+ * outputs are passed on the rising edges of CLK_50 instead, and clk_vga 
+ * stays disabled.
  */
 
 class cDE10Lite : public cTestBench<Vde10lite_verilator_wrapper>, public cObserver
@@ -104,26 +125,66 @@ class cDE10Lite : public cTestBench<Vde10lite_verilator_wrapper>, public cObserv
         static const uint8_t _cNumLed = 10;
         static const uint8_t _cNum7Seg = 6;
         cGuiInterface* _myGUI = nullptr;
+        cEdgeScheduler _scheduler;
+        cTaskPool _tasks{_scheduler};
+        cTrigger _resetTrigger;
         //DE10-Lite ports. Standard ports are of type uint8_t
-        cClock* clk_50;
-        cClock* clk2_50;
-        cClock* clk_adc_10;
-        cClock* clk_vga;
+        cEdgeClock* clk_50;
+        cEdgeClock* clk2_50;
+        cEdgeClock* clk_adc_10;
+        cEdgeClock* clk_vga;
         uint8_t& key;
+#ifdef VDB_NATIVE_VGA
+        uint8_t _vgaPixelClk = 0;           //!< VGA pixel clock, only used by the testbench
+        uint8_t _vgaClkDelayed = 0;         //!< Level of the VGA sample clock at the previous tick
+        bool _vgaOnDesignClock = false;     //!< The VGA outputs are sampled on CLK_50
+        uint32_t _vgaDivider = 0;           //!< CLK_50 cycles per VGA pixel, 0 means detect
+#endif
 
-        cVdbVGAMonitor* _vgaController;
-        cVdbLed* _ledInstances[_cNumLed];
-        cVdb7SegmentDisplay* _7segInstances[_cNum7Seg];
+        cVdbVGAMonitor* _vgaController = nullptr;
+        cVdbLed* _ledInstances[_cNumLed] = {};
+        cVdb7SegmentDisplay* _7segInstances[_cNum7Seg] = {};
 
         std::atomic<eRunState> _returnState = eRunState::completed;
-        std::atomic<eSystemState> _myState = eSystemState::idle;
-        atomic_bool doReset = false;
+        cRunControl _runControl;
+        eSystemState _shownState = eSystemState::idle;  //!< Run state shown on the GUI
+        cTickQuantum _tickQuantum;
+        cPacer _pacer{&_runControl};
+        bool _fastForward = false;      //!< Fast forward active, only used in the verilator thread
+        simtime_t _fastForwardUntil;    //!< Target time of the fast forward
+        bool _skipInitialReset = false; //!< The board is restored from a checkpoint before it is started
+        bool _saveAtPending = false;    //!< A checkpoint is saved at _saveAtTime
+        simtime_t _saveAtTime;          //!< Simulation time to save the checkpoint at
+        std::string _saveAtFile;        //!< File to save the checkpoint to
+        std::string _powerOnFile;       //!< Checkpoint of the initial state, used for a warm restart
+        bool _powerOnReset = true;      //!< A reset is needed after restoring the initial state
+        std::atomic<bool> _warmRestart = false; //!< The initial state is saved, a stop restarts in place
+        bool _sampleTimeBased = false;  //!< The outputs are sampled every _sampleInterval, instead of every quantum
+        simtime_t _sampleInterval;      //!< Simulation time between two samples of the outputs
+        simtime_t _nextSample;          //!< Simulation time of the next sample of the outputs
+        std::unique_ptr<cVdbRecorder> _recorder;    //!< Records the events of the outputs
+        std::unique_ptr<cVgaFrameSink> _frameSink;  //!< Writes the VGA frames into files
+        simtime_t _nextRefresh;         //!< Simulation time of the next LED refresh without a GUI
 
         void setupGUI();
+        uint32_t runQuantum();
+        void showSpeed();
+        void showRunState();
+        void beginFastForward(simtime_t time);
+        void endFastForward();
+        void handleCheckpoint();
+        void checkFrameSink();
+        void warmRestart();
+        void checkSaveAt();
+        void refreshLeds();
+        void sampleOutputs();
+        void createOutputs();
+        void createVgaMonitor();
+        void captureVgaPixel();
 
     protected:
 
-        sCoRoutineHandler<bool> Reset();
+        cTask Reset(bool initialReset);
 
         void notify(eEvent aEvent, void* data);
 
@@ -135,6 +196,22 @@ class cDE10Lite : public cTestBench<Vde10lite_verilator_wrapper>, public cObserv
 
         inline void bitClr8(uint8_t& signal, uint8_t bit){ signal &= ~(1 << bit); }
 
+        cTickQuantum& getTickQuantum() { return _tickQuantum; }
+        cPacer& getPacer() { return _pacer; }
+        cRunControl& getRunControl() { return _runControl; }
+
+        void tick();
+        simtime_t getTime();
+
+        bool saveCheckpoint(std::string fileName);
+        bool restoreCheckpoint(std::string fileName);
+        void saveAt(simtime_t time, std::string fileName);
+        void setSampleInterval(simtime_t interval);
+        void setVgaDivider(uint32_t divider);
+        bool record(std::string fileName);
+        bool dumpVga(std::string fileName, uint32_t first, uint32_t last, uint32_t every);
+
         eRunState run();
         eRunState run(uint32_t numMilliSeconds);
+        eRunState replay(std::string fileName);
 };
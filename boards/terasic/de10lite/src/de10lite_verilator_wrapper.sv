@@ -94,13 +94,27 @@ module de10lite_verilator_wrapper
   //
   genvar n;
 
+  //The testbench samples ledr and hex with VDB_SAMPLED_OUTPUTS
+`ifdef VDB_SAMPLED_OUTPUTS
+  wire [9:0] ledr    /*verilator public*/;
+
+  wire [7:0] hex [6] /*verilator public*/;
+`else
   wire [9:0] ledr;
 
   wire [7:0] hex [6];
-
+`endif
+
+  //The testbench samples the VGA outputs with VDB_NATIVE_VGA
+`ifdef VDB_NATIVE_VGA
+  wire [3:0] vga_r,vga_g,vga_b /*verilator public*/;
+  wire       vga_hsync         /*verilator public*/;
+  wire       vga_vsync         /*verilator public*/;
+`else
   wire [3:0] vga_r,vga_g,vga_b;
   wire       vga_hsync;
   wire       vga_vsync;
+`endif
 
 
   //-------------------------------
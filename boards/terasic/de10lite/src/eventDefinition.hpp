@@ -48,15 +48,24 @@
 #ifndef EVENT_DEFINITION_HPP
 #define EVENT_DEFINITION_HPP
 
+/**
+ * @brief Events of the observer pattern
+ * @note Observers subscribe with a 64 bit mask, so there can be at most 64 events
+ */
 enum class eEvent
 {
     close,
     reset,
     stop,
     stateChange,
+    step,
+    runFor,
+    runUntil,
+    fastForward,
+    saveCheckpoint,
+    restoreCheckpoint,
     vgaDataReady,
-    ledChangedOn,
-    ledChangedOff,
+    ledBrightness,
     sevenSegmentUpdate
 };
 
@@ -60,14 +60,17 @@
 
 #include <noValueOption.hpp>
 #include <valueOption.hpp>
+#include <charconv>
 
 #include "wxWidgetsImplementation.hpp"
+#include "wxWidgetsVdbVGA.hpp"
 
 //Setup namespaces
 using namespace RoaLogic;
 using namespace common;
 using namespace testbench;
 using namespace tasks;
+using namespace testbench::clock::units;
 
 
 //Create program options variable
@@ -81,10 +84,28 @@ cValueOption<std::string> optLog       ("l", "log",      "Set the path for the l
 cValueOption<uint8_t>     optLogLvl    ("",  "level",    "Log level; start loggin from 0=Debug, 1=Log, 2=Info, 3=Warning, 4=Error, 5=Fatal");
 cValueOption<std::string> optInitFile  ("",  "initfile", "Initialisation file for the on-chip RAM");
 cValueOption<uint32_t>    optNoGui     ("",  "nogui",    "Start system without a GUI, possible to add in simulation time in milliseconds");
+cValueOption<uint32_t>    optQuantum   ("",  "quantum",  "Number of ticks between run control checks, 0=adapt to the latency (default), 1=check every tick");
+cValueOption<uint32_t>    optQuantumNs ("",  "quantum-time", "Maximum simulation time in nanoseconds between run control checks");
+cValueOption<uint32_t>    optLatency   ("",  "latency",  "Target GUI latency in microseconds for the adaptive quantum, default 1000");
+cValueOption<std::string> optPace      ("",  "pace",     "Lock the simulation to the wall clock; 1=real time, 0.1 or 1/10=10 times slower than real time");
+cValueOption<uint32_t>    optSkipUntil ("",  "skip-until", "Start the simulation and fast forward to the simulation time in milliseconds, without updating the GUI, the recording or the VGA dump");
+cValueOption<std::string> optSave      ("",  "save",     "Save a checkpoint at a simulation time; <milliseconds>:<file>");
+cValueOption<std::string> optRestore   ("",  "restore",  "Restore a checkpoint before the simulation starts, also after a restart");
+cValueOption<uint32_t>    optSimThreads("",  "sim-threads", "Number of threads used to evaluate the model, requires a model build with THREADS=<n>");
+cValueOption<std::string> optRecord    ("",  "record",   "Record the LED and 7-segment events into a file");
+cValueOption<std::string> optReplay    ("",  "replay",   "Replay a recording on the GUI without simulating the design, use --pace to set the speed");
+cValueOption<uint32_t>    optVgaFps    ("",  "vga-fps",  "Maximum frame rate of the VGA window, 0=no limit, default 60");
+cValueOption<std::string> optVgaDump   ("",  "vga-dump", "Write the VGA frames into <file>.y4m as one stream, or into <file>_<frame>.ppm files, also without a GUI");
+cValueOption<std::string> optVgaFrames ("",  "vga-frames", "Frames written by --vga-dump, <frame> or <first>-<last>, default all");
+cValueOption<uint32_t>    optVgaEvery  ("",  "vga-every", "Write every n-th frame with --vga-dump, default 1");
+cValueOption<uint32_t>    optVgaDivider("",  "vga-divider", "Sample the VGA outputs every n CLK_50 cycles instead of on a pixel clock, 0=detect from the horizontal timing, requires a model build with NATIVE_VGA=1");
+cValueOption<uint32_t>    optSample    ("",  "sample",   "Sample interval in microseconds of the LED and 7-segment outputs, requires a model build with SAMPLED=1, default 0=every GUI update");
+cValueOption<uint32_t>    optSettle    ("",  "settle",   "Time in nanoseconds an output value must be stable before the GUI is updated, default 0=end of the time step");
 
 //type definitions for program options and logger (see bottom of the file)
 int setupProgramOptions(int argc, char** argv);
 void setupLogger(void);
+bool parseNumber(const std::string& text, uint64_t& value);
 
 cVirtualDemoBoard* demoBoard = nullptr;
 std::thread threadGUI;
@@ -94,6 +115,7 @@ int main(int argc, char** argv)
 {
   bool enableTrace = false;
   bool rerun = false;
+  bool firstRun = true;
 
   //first setup the program options
   if (setupProgramOptions(argc,argv))
@@ -113,6 +135,29 @@ int main(int argc, char** argv)
   //parse Verilator options
   contextp->commandArgs(argc, argv);
 
+  //Set the number of model threads, must be done before the model is created
+#ifdef VDB_SIM_THREADS
+  contextp->threads(optSimThreads.isSet() ? optSimThreads.value() : VDB_SIM_THREADS);
+  INFO << "Model evaluates with " << contextp->threads() << " threads\n";
+#else
+  if (optSimThreads.isSet() && optSimThreads.value() > 1)
+  {
+    WARNING << "Model is built single threaded, rebuild with THREADS=" << optSimThreads.value() << " to use multiple threads\n";
+  }
+#endif
+
+  //Glitch filter of the vdb components
+  if (optSettle.isSet())
+  {
+    cVDBCommon::setSettlingWindow(optSettle.value() * 1.0_ns);
+  }
+
+  //Frame rate limit of the VGA window
+  if (optVgaFps.isSet())
+  {
+    cWXVdbVGAMonitor::setMaxFrameRate(optVgaFps.value());
+  }
+
   if(!optNoGui.isSet())
   {
     // Create GUI and start it on different thread
@@ -127,6 +172,63 @@ int main(int argc, char** argv)
     //create testbench
     cDE10Lite* de10lite = new cDE10Lite(contextp.get(), enableTrace, demoBoard);
 
+    //Setup the tick quantum
+    if (optQuantum.isSet())
+    {
+      de10lite->getTickQuantum().setTicks(optQuantum.value());
+    }
+
+    if (optQuantumNs.isSet())
+    {
+      de10lite->getTickQuantum().setTime(optQuantumNs.value() * 1.0_ns);
+    }
+
+    if (optLatency.isSet())
+    {
+      de10lite->getTickQuantum().setTargetLatency(std::chrono::microseconds(optLatency.value()));
+    }
+
+    //Sample the VGA outputs on CLK_50
+#ifdef VDB_NATIVE_VGA
+    if (optVgaDivider.isSet())
+    {
+      de10lite->setVgaDivider(optVgaDivider.value());
+    }
+#else
+    if (optVgaDivider.isSet() && firstRun)
+    {
+      WARNING << "VGA monitor has its own pixel clock, rebuild with NATIVE_VGA=1 to sample the VGA outputs on CLK_50\n";
+    }
+#endif
+
+    //Setup the sampling of the outputs
+#ifdef VDB_SAMPLED_OUTPUTS
+    if (optSample.isSet())
+    {
+      de10lite->setSampleInterval(optSample.value() * 1.0_us);
+    }
+#else
+    if (optSample.isSet() && firstRun)
+    {
+      WARNING << "Model calls the DPI functions of the outputs, rebuild with SAMPLED=1 to sample them\n";
+    }
+#endif
+
+    //Setup wall clock pacing
+    if (optPace.isSet())
+    {
+      if (!de10lite->getPacer().setRatio(optPace.value()))
+      {
+        WARNING << "Invalid pace ratio " << optPace.value() << ", simulation is not paced\n";
+      }
+    }
+
+    //Fast forward through the boot sequence, only on the first run
+    if (optSkipUntil.isSet() && firstRun)
+    {
+      de10lite->getRunControl().fastForward(optSkipUntil.value() * 1000.0_us);
+    }
+
     //Initialize RAMs
     if (optInitFile.isSet())
     {
@@ -144,6 +246,28 @@ int main(int argc, char** argv)
       }
     }
 
+    //Restore a checkpoint, after the RAM initialisation so that the checkpoint content is used
+    if (optRestore.isSet())
+    {
+      de10lite->restoreCheckpoint(optRestore.value());
+    }
+
+    //Save a checkpoint at a simulation time, only on the first run
+    if (optSave.isSet() && firstRun)
+    {
+      std::vector<string> save_string = split(optSave.value(), ':');
+      uint64_t saveMs = 0;
+
+      if(save_string.size() == 2 && parseNumber(save_string[0], saveMs))
+      {
+        de10lite->saveAt(saveMs * 1000.0_us, save_string[1]);
+      }
+      else
+      {
+        WARNING << "Wrong save option passed, expected <milliseconds>:<file>\n";
+      }
+    }
+
     //Open waveform dump file if enabled
     if (enableTrace)
     {
@@ -157,8 +281,55 @@ int main(int argc, char** argv)
       }
     }
 
+    //Record the outputs, only on the first run
+    if (optRecord.isSet() && firstRun && !optReplay.isSet())
+    {
+      de10lite->record(optRecord.value());
+    }
+
+    //Write the VGA frames, only on the first run
+    if (optVgaDump.isSet() && firstRun && !optReplay.isSet())
+    {
+      uint32_t first = 0;
+      uint32_t last = UINT32_MAX;
+
+      if (optVgaFrames.isSet())
+      {
+        std::vector<string> frames_string = split(optVgaFrames.value(), '-');
+        uint64_t firstFrame = 0;
+        uint64_t lastFrame = 0;
+
+        //split() drops a trailing empty string, so "3-" is checked separately
+        if(frames_string.size() >= 1 && frames_string.size() <= 2 && optVgaFrames.value().back() != '-' &&
+           parseNumber(frames_string.front(), firstFrame) && parseNumber(frames_string.back(), lastFrame) &&
+           firstFrame <= lastFrame && lastFrame <= UINT32_MAX)
+        {
+          first = firstFrame;
+          last = lastFrame;
+        }
+        else
+        {
+          WARNING << "Wrong VGA frames option passed, expected <frame> or <first>-<last> with first <= last <= " << UINT32_MAX << "\n";
+        }
+      }
+
+      de10lite->dumpVga(optVgaDump.value(), first, last, optVgaEvery.isSet() ? optVgaEvery.value() : 1);
+    }
+
+    if (optReplay.isSet() && optNoGui.isSet() && firstRun)
+    {
+      WARNING << "A recording can only be replayed on the GUI, the design is simulated instead\n";
+    }
+
     //Run the testbench
-    if(optNoGui.isSet())
+    if(optReplay.isSet() && !optNoGui.isSet())
+    {
+      if(de10lite->replay(optReplay.value()) == eRunState::restart)
+      {
+        rerun = true;
+      }
+    }
+    else if(optNoGui.isSet())
     {
       de10lite->run(optNoGui.value());
     }
@@ -172,6 +343,7 @@ int main(int argc, char** argv)
 
     //close testbench
     delete de10lite;
+    firstRun = false;
   } while (rerun);
   
   // Close GUI
@@ -208,6 +380,23 @@ int setupProgramOptions(int argc, char** argv)
     programOptions.add(&optLogLvl);
     programOptions.add(&optInitFile);
     programOptions.add(&optNoGui);
+    programOptions.add(&optQuantum);
+    programOptions.add(&optQuantumNs);
+    programOptions.add(&optLatency);
+    programOptions.add(&optPace);
+    programOptions.add(&optSkipUntil);
+    programOptions.add(&optSave);
+    programOptions.add(&optRestore);
+    programOptions.add(&optSimThreads);
+    programOptions.add(&optRecord);
+    programOptions.add(&optReplay);
+    programOptions.add(&optVgaFps);
+    programOptions.add(&optVgaDump);
+    programOptions.add(&optVgaFrames);
+    programOptions.add(&optVgaEvery);
+    programOptions.add(&optVgaDivider);
+    programOptions.add(&optSample);
+    programOptions.add(&optSettle);
 
     programOptions.parse(argc, argv);
 
@@ -256,3 +445,22 @@ void setupLogger(void)
 
     INFO << "Started log with level: " << logLvl << "\n";
 }
+
+
+/**
+ * @brief Parse a decimal number of a program option
+ * @details Unlike std::stoul this doesn't throw, a sign, other characters
+ * or a number that doesn't fit are rejected.
+ * 
+ * @param[in]  text     The text to parse
+ * @param[out] value    The number
+ * 
+ * @return true when the whole text is a valid number
+ */
+bool parseNumber(const std::string& text, uint64_t& value)
+{
+    const char* end = text.data() + text.size();
+    auto [next, error] = std::from_chars(text.data(), end, value);
+
+    return !text.empty() && error == std::errc() && next == end;
+}
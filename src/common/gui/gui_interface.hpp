@@ -49,6 +49,7 @@
 #include "subject.hpp"
 #include "vdbCommon.hpp"
 #include "distance.hpp"
+#include "vdbEventChannel.hpp"
 
 namespace RoaLogic {
     using namespace observer;
@@ -246,12 +247,19 @@ namespace GUI {
      * of these function or sending a notification, the corresponding
      * function is still in the callers context. 
      * 
+     * The exception is removeVdbComponents(), which removes the GUI 
+     * components synchronously and shall only be called from the GUI 
+     * thread, e.g. from the notify() function of an observer.
+     * 
      */
     class cGuiInterface : public cSubject
     {
         public:
         virtual void setupGui(std::string applicationName, std::string aboutTitle, std::string aboutText, distanceSize minimalScreenSize, sRGBColor backgroundColor) = 0;
         virtual void addVdbComponent(eVdbComponentType type, cVDBCommon* vdbComponent, distancePoint point, void* information, double angle=0) = 0;
+        virtual void setStatusText(std::string text) = 0;
+        virtual void setRunState(eSystemState state) = 0;
+        virtual void removeVdbComponents() = 0;
     };
 
     /**
@@ -265,6 +273,10 @@ namespace GUI {
      * a verilated vdb component. It makes sure that all events from the
      * verilated vdb component are passed through the notify function.
      * 
+     * The notify function runs in the verilator thread. A component can pass
+     * the event to the GUI thread with postGuiEvent(), the event is then 
+     * handled in onGuiEvent() in the GUI thread, see cVdbEventChannel.
+     * 
      * @todo: Add a method to sent data from the GUI to the verilated design
      */
     class cGuiVDBComponent : public cObserver
@@ -301,6 +313,23 @@ namespace GUI {
             return static_cast<int>(getID());
         }
 
+        /**
+         * @brief Pass an event to the GUI thread
+         * @note Runs in the verilator thread context
+         * 
+         * @return false when the event replaced a pending event of this component
+         */
+        bool postGuiEvent(eEvent aEvent, uint32_t value = 0)
+        {
+            return cVdbEventChannel::instance().post(this, aEvent, value);
+        }
+
+        /**
+         * @brief Handle an event posted with postGuiEvent()
+         * @note Runs in the GUI thread context
+         */
+        virtual void onGuiEvent(eEvent aEvent, uint32_t value){};
+
         virtual void onClose(){};
         virtual void notify(eEvent aEvent, void* data) = 0;
     };
@@ -0,0 +1,146 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Single producer single consumer ring C++ header file         //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+
+namespace RoaLogic {
+namespace GUI {
+
+    /**
+     * @class cSpscRing
+     * @brief Bounded lock-free single producer single consumer ring
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details One thread pushes elements, another thread pops them. Both 
+     * sides only use atomic loads and stores on the head and tail index, so 
+     * neither side ever blocks. When the ring is full push() fails, it is up
+     * to the producer to decide what happens with the element.
+     * 
+     * The head and tail index are placed on their own cache line, so the 
+     * producer and consumer don't invalidate each others cache line on every 
+     * element.
+     * 
+     * @attention tSize shall be a power of two
+     */
+    template <class T, size_t tSize>
+    class cSpscRing
+    {
+        static_assert(tSize != 0 && (tSize & (tSize - 1)) == 0, "The ring size shall be a power of two");
+
+        private:
+        static const size_t cMask = tSize - 1;
+        static const size_t cCacheLine = 64;
+
+        alignas(cCacheLine) std::atomic<size_t> _head{0};  //!< Next element to pop, written by the consumer
+        alignas(cCacheLine) std::atomic<size_t> _tail{0};  //!< Next element to push, written by the producer
+        alignas(cCacheLine) std::array<T, tSize> _buffer;  //!< The elements
+
+        public:
+        /**
+         * @brief Push an element
+         * @note Shall only be called by the producer
+         * 
+         * @param[in] element   The element to push
+         * @return false when the ring is full
+         */
+        bool push(const T& element)
+        {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+
+            if(tail - _head.load(std::memory_order_acquire) == tSize)
+            {
+                return false;
+            }
+
+            _buffer[tail & cMask] = element;
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Pop an element
+         * @note Shall only be called by the consumer
+         * 
+         * @param[out] element  The popped element
+         * @return false when the ring is empty
+         */
+        bool pop(T& element)
+        {
+            const size_t head = _head.load(std::memory_order_relaxed);
+
+            if(head == _tail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            element = _buffer[head & cMask];
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Check if the ring is empty
+         * @note Exact for the consumer, a snapshot for the producer
+         */
+        bool empty() const
+        {
+            return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Get the capacity of the ring
+         */
+        static constexpr size_t capacity() { return tSize; }
+    };
+
+}}
+
+#endif // SPSC_RING_HPP
@@ -0,0 +1,204 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Triple buffer stress test                                    //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "tripleBuffer.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+/**
+ * @file tripleBufferStress.cpp
+ * @brief Stress test of cTripleBuffer
+ * @version 0.1
+ * @date 16-oct-2026
+ * 
+ * @details A producer thread publishes numbered frames as fast as it can, 
+ * while the consumer thread takes them. Every word of a frame is derived 
+ * from its number. The test checks that:
+ * - a taken frame is never torn, all words belong to the same frame, also
+ *   after the producer continued.
+ * - the frame numbers only increase, a frame is never taken twice or out of order.
+ * - the last published frame is always taken.
+ * 
+ * Build and run with "make" in this directory, "make TSAN=1" runs it with
+ * the thread sanitizer. The number of frames is the first argument.
+ */
+
+using namespace RoaLogic::GUI;
+
+namespace
+{
+    const uint64_t cYieldInterval = 16;     //!< Frames between yields of the producer, interleaves the threads on a single core
+
+    /**
+     * @brief A frame, large enough that a torn copy is likely to show
+     */
+    struct sFrame
+    {
+        uint64_t number = 0;                    //!< Frame number, 0 is never published
+        std::array<uint64_t, 256> words{};      //!< Derived from the number
+    };
+
+    uint64_t word(uint64_t number, size_t i)
+    {
+        return number * 0x9e3779b97f4a7c15ull + i;
+    }
+
+    bool check(bool condition, const std::string& message)
+    {
+        if(!condition)
+        {
+            std::cout << "FAIL: " << message << "\n";
+        }
+
+        return condition;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint64_t numFrames = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 200000;
+
+    cTripleBuffer<sFrame> buffer;
+    std::atomic<bool> started{false};
+    std::atomic<bool> produced{false};
+    uint64_t taken = 0;
+    uint64_t torn = 0;
+    uint64_t outOfOrder = 0;
+    uint64_t last = 0;
+
+    std::thread consumer([&]
+    {
+        started.store(true, std::memory_order_release);
+
+        // The producer is done and its last frame is taken
+        while(!(produced.load(std::memory_order_acquire) && last == numFrames))
+        {
+            if(!buffer.acquire())
+            {
+                continue;
+            }
+
+            const sFrame& frame = buffer.front();
+            const uint64_t number = frame.number;
+
+            // Check the frame again after the producer had a chance to run,
+            // the front buffer shall not change while the consumer holds it
+            for(int pass = 0; pass < 2 && !torn; pass++)
+            {
+                for(size_t i = 0; i < frame.words.size(); i++)
+                {
+                    if(frame.number != number || frame.words[i] != word(number, i))
+                    {
+                        torn++;
+                        break;
+                    }
+                }
+
+                std::this_thread::yield();
+            }
+
+            if(number <= last)
+            {
+                outOfOrder++;
+            }
+
+            last = number;
+            taken++;
+
+            // Stop on the first failure, a lost frame would keep the loop running
+            if(torn || outOfOrder)
+            {
+                break;
+            }
+        }
+    });
+
+    // Don't publish most frames before the consumer runs
+    while(!started.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    for(uint64_t number = 1; number <= numFrames; number++)
+    {
+        sFrame& frame = buffer.back();
+
+        frame.number = number;
+
+        for(size_t i = 0; i < frame.words.size(); i++)
+        {
+            frame.words[i] = word(number, i);
+        }
+
+        buffer.publish();
+
+        if(number % cYieldInterval == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    produced.store(true, std::memory_order_release);
+    consumer.join();
+
+    std::cout << numFrames << " frames published, " << taken << " taken\n";
+
+    bool ok = true;
+
+    ok &= check(torn == 0, "torn frame taken");
+    ok &= check(outOfOrder == 0, "frame taken twice or out of order");
+    ok &= check(last == numFrames, "last frame not taken");
+    ok &= check(!buffer.acquire(), "new frame reported after the last frame was taken");
+
+    std::cout << (ok ? "PASS" : "FAILED") << "\n";
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
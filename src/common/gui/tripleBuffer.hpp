@@ -0,0 +1,131 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Lock-free triple buffer                                      //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+
+namespace RoaLogic {
+namespace GUI {
+
+    /**
+     * @class cTripleBuffer
+     * @brief Lock-free exchange of the newest value between two threads
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details The producer fills the back buffer and publishes it, the 
+     * consumer takes the newest published buffer as its front buffer. The 
+     * third buffer is the one in the middle, it holds the last published 
+     * value until it is taken or replaced by a newer one.
+     * 
+     * Publishing and taking a buffer only exchange the index of the middle
+     * buffer, so neither side ever waits for the other and the buffers are
+     * never copied. When the producer is faster than the consumer the older
+     * values are overwritten, the consumer always gets the newest one.
+     * 
+     * @attention There shall be one producer and one consumer thread
+     */
+    template <class T>
+    class cTripleBuffer
+    {
+        private:
+        static const uint8_t cIndexMask = 0x3;  //!< Index bits of _middle
+        static const uint8_t cNewFlag   = 0x4;  //!< The middle buffer holds a value that isn't taken yet
+
+        std::array<T, 3> _buffers;
+        uint8_t _back = 0;                      //!< Buffer of the producer
+        std::atomic<uint8_t> _middle{1};        //!< Exchanged buffer, with cNewFlag
+        uint8_t _front = 2;                     //!< Buffer of the consumer
+
+        public:
+        /**
+         * @brief Get the back buffer
+         * @note Shall only be called by the producer
+         */
+        T& back() { return _buffers[_back]; }
+
+        /**
+         * @brief Publish the back buffer
+         * @details The back buffer becomes the newest value, the producer 
+         * continues with the previous middle buffer.
+         * @note Shall only be called by the producer
+         */
+        void publish()
+        {
+            _back = _middle.exchange(_back | cNewFlag, std::memory_order_acq_rel) & cIndexMask;
+        }
+
+        /**
+         * @brief Take the newest published buffer
+         * @details When a new value is published it becomes the front buffer.
+         * @note Shall only be called by the consumer
+         * 
+         * @return false when no new value is published since the last call
+         */
+        bool acquire()
+        {
+            if(!(_middle.load(std::memory_order_relaxed) & cNewFlag))
+            {
+                return false;
+            }
+
+            _front = _middle.exchange(_front, std::memory_order_acq_rel) & cIndexMask;
+            return true;
+        }
+
+        /**
+         * @brief Get the front buffer
+         * @note Shall only be called by the consumer
+         */
+        T& front() { return _buffers[_front]; }
+    };
+
+}}
+
+#endif // TRIPLE_BUFFER_HPP
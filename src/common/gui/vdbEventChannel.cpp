@@ -0,0 +1,278 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    vdb to GUI event channel C++ file                            //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "vdbEventChannel.hpp"
+#include "gui_interface.hpp"
+#include "log.hpp"
+
+namespace RoaLogic {
+namespace GUI {
+
+    /**
+     * @brief Get the event channel of the GUI
+     */
+    cVdbEventChannel& cVdbEventChannel::instance()
+    {
+        static cVdbEventChannel channel;
+        return channel;
+    }
+
+    /**
+     * @brief Set the wakeup function
+     * @details The function is called from the verilator thread for the
+     * first event of a batch. It shall post a single event to the GUI 
+     * thread, which then calls drain(). Pass nullptr to stop the wakeups.
+     * 
+     * @param[in] wakeup    Function that wakes up the GUI thread
+     */
+    void cVdbEventChannel::setWakeup(std::function<void()> wakeup)
+    {
+        std::lock_guard<std::mutex> lock(_wakeupMutex);
+        _wakeup = wakeup;
+    }
+
+    /**
+     * @brief Place an event in the overflow table
+     * @details An event of the same target and event type is replaced.
+     * 
+     * @param[in]  element      The event
+     * @param[out] coalesced    The event replaced a pending event
+     * @return false when the table is drained in the meantime, the event
+     * then goes into the ring
+     */
+    bool cVdbEventChannel::postOverflow(const sVdbGuiEvent& element, bool& coalesced)
+    {
+        std::lock_guard<std::mutex> lock(_overflowMutex);
+
+        if(!_overflowPending.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        for(sVdbGuiEvent& pending : _overflow)
+        {
+            if(pending.target == element.target && pending.event == element.event)
+            {
+                pending.value = element.value;
+                coalesced = true;
+                return true;
+            }
+        }
+
+        _overflow.push_back(element);
+        return true;
+    }
+
+    /**
+     * @brief Post an event to a GUI component
+     * @details Places the event in the ring, when the GUI isn't woken up
+     * yet the wakeup function is called. When the ring is full the event
+     * is placed in the overflow table, as are all following events until
+     * the GUI drained the table.
+     * 
+     * @note Runs in the verilator thread context
+     * 
+     * @param[in] target    The GUI component that handles the event
+     * @param[in] event     The event
+     * @param[in] value     Event data, specific to the component
+     * @return false when the event replaced a pending event of the same target
+     */
+    bool cVdbEventChannel::post(cGuiVDBComponent* target, eEvent event, uint32_t value)
+    {
+        sVdbGuiEvent element{target, event, value};
+        bool coalesced = false;
+
+        {
+            tProducerLock lock(_producerMutex);
+
+            bool inTable = false;
+
+            // While the table is in use a newer event must not pass the 
+            // events in the table through the ring
+            if(_overflowPending.load(std::memory_order_acquire))
+            {
+                inTable = postOverflow(element, coalesced);
+            }
+
+            if(!inTable && !_ring.push(element))
+            {
+                std::lock_guard<std::mutex> overflowLock(_overflowMutex);
+                _overflowPending.store(true, std::memory_order_release);
+                _overflow.push_back(element);
+            }
+        }
+
+        _enqueued.fetch_add(1, std::memory_order_relaxed);
+
+        if(coalesced)
+        {
+            _coalesced.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Pairs with the fence in drain(), either the GUI sees this event 
+        // or we see that the wakeup is not pending anymore
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(!_wakeupPending.exchange(true))
+        {
+            std::lock_guard<std::mutex> lock(_wakeupMutex);
+
+            if(_wakeup)
+            {
+                _wakeups.fetch_add(1, std::memory_order_relaxed);
+                _wakeup();
+            }
+            else
+            {
+                // No GUI to wake up yet, try again on the next event
+                _wakeupPending.store(false);
+            }
+        }
+
+        return !coalesced;
+    }
+
+    /**
+     * @brief Handle all pending events
+     * @details The wakeup is cleared before the ring is read, so an 
+     * event posted during the drain wakes up the GUI again. The overflow
+     * table is handled after the ring, its events are newer.
+     * 
+     * @note Runs in the GUI thread context
+     * 
+     * @return The number of handled events
+     */
+    size_t cVdbEventChannel::drain()
+    {
+        sVdbGuiEvent element;
+        size_t count = 0;
+
+        _wakeupPending.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        while(_ring.pop(element))
+        {
+            element.target->onGuiEvent(element.event, element.value);
+            count++;
+        }
+
+        if(_overflowPending.load(std::memory_order_acquire))
+        {
+            std::vector<sVdbGuiEvent> overflow;
+
+            {
+                std::lock_guard<std::mutex> lock(_overflowMutex);
+                overflow.swap(_overflow);
+                _overflowPending.store(false, std::memory_order_relaxed);
+            }
+
+            for(const sVdbGuiEvent& pending : overflow)
+            {
+                pending.target->onGuiEvent(pending.event, pending.value);
+            }
+
+            count += overflow.size();
+        }
+
+        _drained.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    /**
+     * @brief Throw away all pending events
+     * @details Used when the GUI components are removed, pending events
+     * would otherwise be handled by a deleted component. The discarded
+     * events, also those in the overflow table, are counted as dropped.
+     * 
+     * @note Runs in the GUI thread context
+     */
+    void cVdbEventChannel::discard()
+    {
+        sVdbGuiEvent element;
+        uint64_t count = 0;
+
+        while(_ring.pop(element))
+        {
+            count++;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_overflowMutex);
+            count += _overflow.size();
+            _overflow.clear();
+            _overflowPending.store(false, std::memory_order_relaxed);
+        }
+
+        _dropped.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the statistics of the channel
+     */
+    sVdbEventChannelCounters cVdbEventChannel::getCounters() const
+    {
+        return sVdbEventChannelCounters{_enqueued.load(std::memory_order_relaxed),
+                                        _drained.load(std::memory_order_relaxed),
+                                        _coalesced.load(std::memory_order_relaxed),
+                                        _dropped.load(std::memory_order_relaxed),
+                                        _wakeups.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @brief Report the statistics of the channel
+     */
+    void cVdbEventChannel::report() const
+    {
+        sVdbEventChannelCounters counters = getCounters();
+
+        if(counters.enqueued > 0 || counters.dropped > 0)
+        {
+            INFO << "GUI events: " << counters.enqueued << " enqueued, " << counters.drained << " drained, "
+                 << counters.coalesced << " coalesced, " << counters.dropped << " dropped, " 
+                 << counters.wakeups << " wakeups\n";
+        }
+    }
+
+}}
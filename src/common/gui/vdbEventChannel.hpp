@@ -0,0 +1,165 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    vdb to GUI event channel C++ header file                     //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef VDB_EVENT_CHANNEL_HPP
+#define VDB_EVENT_CHANNEL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "eventDefinition.hpp"
+#include "spscRing.hpp"
+
+namespace RoaLogic {
+namespace GUI {
+
+    class cGuiVDBComponent;
+
+    /**
+     * @struct sVdbGuiEvent
+     * @brief Event from a vdb component to its GUI component
+     */
+    struct sVdbGuiEvent
+    {
+        cGuiVDBComponent* target;   //!< The GUI component that handles the event
+        eEvent event;               //!< The event of the vdb component
+        uint32_t value;             //!< Event data, specific to the component
+    };
+
+    /**
+     * @struct sVdbEventChannelCounters
+     * @brief Statistics of the event channel
+     */
+    struct sVdbEventChannelCounters
+    {
+        uint64_t enqueued;          //!< Number of events placed in the channel
+        uint64_t drained;           //!< Number of events handled by the GUI
+        uint64_t coalesced;         //!< Number of events replaced by a newer event of the same target while the channel was full
+        uint64_t dropped;           //!< Number of events thrown away by discard()
+        uint64_t wakeups;           //!< Number of times the GUI was woken up
+    };
+
+    /**
+     * @class cVdbEventChannel
+     * @brief Event channel from the verilator thread to the GUI thread
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details Posting a GUI framework event for every change of a component 
+     * takes the lock of the GUI framework and allocates an event each time. A 
+     * fast toggling design then stalls the simulation on the GUI. Instead the
+     * components post small events into a bounded lock-free ring.
+     * 
+     * Only the first event of a batch wakes up the GUI, through the wakeup 
+     * function set by the GUI implementation. The GUI then drains all events 
+     * in one go with drain(), which calls onGuiEvent() of each target in the 
+     * GUI thread. The simulation never waits for the GUI. When the ring is full
+     * the events are kept in an overflow table instead, with the latest event 
+     * per target and event type. Until the GUI drained the table all events 
+     * go there, so the last state of a component is never lost and is 
+     * handled after the older events in the ring.
+     * 
+     * There is one channel for the GUI, see instance(). 
+     * 
+     * @note The ring has a single producer. When the model is verilated with 
+     * multiple threads (VDB_SIM_THREADS) the producers are serialized with a
+     * mutex, in a single threaded build the lock compiles away.
+     */
+    class cVdbEventChannel
+    {
+        public:
+        static const size_t cCapacity = 4096;   //!< Maximum number of pending events
+
+        private:
+#ifdef VDB_SIM_THREADS
+        typedef std::mutex                  tProducerMutex;
+        typedef std::lock_guard<std::mutex> tProducerLock;
+#else
+        struct sNoLock
+        {
+            sNoLock() {}
+            template <class T> explicit sNoLock(T&) {}
+        };
+        typedef sNoLock tProducerMutex;
+        typedef sNoLock tProducerLock;
+#endif
+
+        cSpscRing<sVdbGuiEvent, cCapacity> _ring;   //!< The pending events
+        tProducerMutex _producerMutex;              //!< Serializes the producers
+
+        std::atomic<bool> _wakeupPending{false};    //!< The GUI is woken up but didn't drain yet
+        std::mutex _wakeupMutex;                    //!< Protects _wakeup
+        std::function<void()> _wakeup;              //!< Wakes up the GUI thread
+
+        std::atomic<bool> _overflowPending{false};  //!< The events are placed in _overflow
+        std::mutex _overflowMutex;                  //!< Protects _overflow
+        std::vector<sVdbGuiEvent> _overflow;        //!< Latest event per target and event type
+
+        std::atomic<uint64_t> _enqueued{0};
+        std::atomic<uint64_t> _drained{0};
+        std::atomic<uint64_t> _coalesced{0};
+        std::atomic<uint64_t> _dropped{0};
+        std::atomic<uint64_t> _wakeups{0};
+
+        bool postOverflow(const sVdbGuiEvent& element, bool& coalesced);
+
+        public:
+        static cVdbEventChannel& instance();
+
+        void setWakeup(std::function<void()> wakeup);
+        bool post(cGuiVDBComponent* target, eEvent event, uint32_t value = 0);
+        size_t drain();
+        void discard();
+
+        sVdbEventChannelCounters getCounters() const;
+        void report() const;
+    };
+
+}}
+
+#endif // VDB_EVENT_CHANNEL_HPP
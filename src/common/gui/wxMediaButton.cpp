@@ -195,7 +195,7 @@ wxMediaPlayPauseButton::wxMediaPlayPauseButton(wxWindow* parent, wxWindowID id,
   wxMediaButton(parent, id, GetLabel(), pos, GetDefaultSize(), style, validator, name)
 {
     //Determine button phase
-    if (label.IsSameAs("pause"),false)
+    if (label.IsSameAs("pause",false))
     {
       phase = PAUSE;
     }
@@ -224,7 +224,7 @@ wxString wxMediaPlayPauseButton::GetLabel() const
 void wxMediaPlayPauseButton::SetLabel(const wxString& label)
 {
     //Determine button phase
-    if (label.IsSameAs("pause"),false)
+    if (label.IsSameAs("pause",false))
     {
       phase = PAUSE;
     }
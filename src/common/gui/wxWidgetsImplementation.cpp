@@ -107,3 +107,33 @@ void cVirtualDemoBoard::addVdbComponent(eVdbComponentType type, cVDBCommon* vdbC
     statusEvent.SetClientObject(eventData);
     wxPostEvent(_mainFrame, statusEvent);
 }
+
+void cVirtualDemoBoard::setStatusText(std::string text)
+{
+    wxCommandEvent statusEvent{wxEVT_STATUS_TEXT};
+
+    statusEvent.SetString(text);
+    wxPostEvent(_mainFrame, statusEvent);
+}
+
+/**
+ * @brief Show the run state of the board
+ * @details The state is changed by the controls of the GUI, but also by
+ * the board itself, e.g. when a step ends. The controls follow the state.
+ */
+void cVirtualDemoBoard::setRunState(eSystemState state)
+{
+    wxCommandEvent stateEvent{wxEVT_RUN_STATE};
+
+    stateEvent.SetInt(static_cast<int>(state));
+    wxPostEvent(_mainFrame, stateEvent);
+}
+
+/**
+ * @brief Remove all vdb components from the board
+ * @note Runs in the GUI thread, the components are removed before this function returns
+ */
+void cVirtualDemoBoard::removeVdbComponents()
+{
+    _mainFrame->removeVdbComponents();
+}
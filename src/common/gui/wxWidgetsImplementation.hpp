@@ -88,6 +88,9 @@ class cVirtualDemoBoard : public wxApp, public cGuiInterface
 
     void setupGui(std::string applicationName, std::string aboutTitle, std::string aboutText, distanceSize minimalScreenSize, sRGBColor backgroundColor);
     void addVdbComponent(eVdbComponentType type, cVDBCommon* vdbComponent, distancePoint point, void* information, double angle=0);
+    void setStatusText(std::string text);
+    void setRunState(eSystemState state);
+    void removeVdbComponents();
 };
 
 
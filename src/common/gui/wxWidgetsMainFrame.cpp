@@ -53,9 +53,17 @@
 #include "wxWidgetsVdbConnector.hpp"
 #include "wxWidgetsVdbHeader.hpp"
 
+#include <wx/numdlg.h>
+#include <wx/filedlg.h>
+
+
+using namespace RoaLogic::testbench::clock::units;
 
 wxDEFINE_EVENT(wxEVT_CHANGE_FRAME, wxCommandEvent);
 wxDEFINE_EVENT(wxEVT_ADD_VDB, wxCommandEvent);
+wxDEFINE_EVENT(wxEVT_STATUS_TEXT, wxCommandEvent);
+wxDEFINE_EVENT(wxEVT_RUN_STATE, wxCommandEvent);
+wxDEFINE_EVENT(wxEVT_VDB_EVENTS, wxCommandEvent);
 
 cMainFrame::cMainFrame(cSubject* aSubject) :
     wxFrame(nullptr, wxID_ANY, _myApplicationName.c_str()), //wxDefaultPosition, wxDefaultSize, wxDEFAULT_FRAME_STYLE & ~(wxRESIZE_BORDER | wxMAXIMIZE_BOX)),
@@ -66,21 +74,35 @@ cMainFrame::cMainFrame(cSubject* aSubject) :
      *********************************/
     wxMenu *menuFile = new wxMenu;
 
+    menuFile->Append(cSaveMenuID, "&Save checkpoint...", "Save the state of the board into a checkpoint");
+    menuFile->Append(cRestoreMenuID, "&Restore checkpoint...", "Restore the state of the board from a checkpoint");
     menuFile->AppendSeparator();
     menuFile->Append(wxID_EXIT);
 
+    wxMenu* menuSimulation = new wxMenu;
+    menuSimulation->Append(cStepMenuID, "&Step\tF10", "Run a single clock cycle");
+    menuSimulation->Append(cStepNMenuID, "Step &N cycles...", "Run a number of clock cycles");
+    menuSimulation->AppendSeparator();
+    menuSimulation->Append(cRunForMenuID, "Run &for...", "Run for a simulation time");
+    menuSimulation->Append(cRunUntilMenuID, "Run &until...", "Run until a simulation time");
+    menuSimulation->Append(cFastForwardMenuID, "Fast f&orward...", "Run until a simulation time without updating the board");
+
     wxMenu* menuHelp = new wxMenu;
     menuHelp->Append(wxID_ABOUT);
 
     wxMenuBar* menuBar = new wxMenuBar;
     menuBar->Append(menuFile, "&File");
+    menuBar->Append(menuSimulation, "&Simulation");
     menuBar->Append(menuHelp, "&help");
     Bind(wxEVT_MENU, &cMainFrame::OnExit, this, wxID_EXIT);
     Bind(wxEVT_MENU, &cMainFrame::OnAbout, this, wxID_ABOUT);
+    Bind(wxEVT_MENU, &cMainFrame::onMenuStep, this, cStepMenuID, cStepNMenuID);
+    Bind(wxEVT_MENU, &cMainFrame::onMenuRunTime, this, cRunForMenuID, cFastForwardMenuID);
+    Bind(wxEVT_MENU, &cMainFrame::onMenuCheckpoint, this, cSaveMenuID, cRestoreMenuID);
 
     SetMenuBar(menuBar);
 
-    //CreateStatusBar();
+    CreateStatusBar();
 
     /*********************************
      * Setup left panel of the system
@@ -117,11 +139,22 @@ cMainFrame::cMainFrame(cSubject* aSubject) :
 
     Bind(wxEVT_CHANGE_FRAME, &cMainFrame::onChangeFrame, this, wxID_ANY);
     Bind(wxEVT_ADD_VDB, &cMainFrame::onAddVdb, this, wxID_ANY);
+    Bind(wxEVT_STATUS_TEXT, &cMainFrame::onStatusText, this, wxID_ANY);
+    Bind(wxEVT_RUN_STATE, &cMainFrame::onRunState, this, wxID_ANY);
+    Bind(wxEVT_VDB_EVENTS, &cMainFrame::onVdbEvents, this, wxID_ANY);
     Bind(wxEVT_SIZE, &cMainFrame::onSize, this);
+
+    // A single wxWidgets event per batch of vdb events
+    cVdbEventChannel::instance().setWakeup([this]()
+    {
+        wxQueueEvent(this, new wxCommandEvent(wxEVT_VDB_EVENTS));
+    });
 }
 
 cMainFrame::~cMainFrame()
 {
+    cVdbEventChannel::instance().setWakeup(nullptr);
+
     for(cGuiVDBComponent* vdb : vdbInstances)
     {
         // Remove observer at this point, so we don't receive any events anymore
@@ -129,6 +162,9 @@ cMainFrame::~cMainFrame()
         vdb->removeObserver();
         vdb->onClose();
     }
+
+    cVdbEventChannel::instance().discard();
+    cVdbEventChannel::instance().report();
 }
 
 void cMainFrame::onChangeFrame(wxCommandEvent& event)
@@ -201,10 +237,25 @@ void cMainFrame::onButtonReset(wxCommandEvent& event)
     _subject->notifyObserver(eEvent::reset);
 }
 
+/**
+ * @brief Handle the stop button
+ * @details The board decides how it restarts. A warm restart keeps all
+ * components, otherwise the board removes them through removeVdbComponents().
+ */
 void cMainFrame::onButtonStop(wxCommandEvent& event)
 {
     _startButton->SetLabel("Start");
 
+    _subject->notifyObserver(eEvent::stop);
+}
+
+/**
+ * @brief Remove all vdb components from the board
+ * @details Used when the board is rebuilt, the verilated components 
+ * are deleted by the board itself.
+ */
+void cMainFrame::removeVdbComponents()
+{
     for(cGuiVDBComponent* vdb : vdbInstances)
     {
         // Remove observer at this point, so we don't receive any events anymore
@@ -213,11 +264,118 @@ void cMainFrame::onButtonStop(wxCommandEvent& event)
         vdb->onClose();
     }
 
+    // Pending events would be handled by a deleted component
+    cVdbEventChannel::instance().discard();
+
     _rightPanel->DestroyChildren();
 
     vdbInstances.erase(vdbInstances.begin(), vdbInstances.end());
+}
 
-    _subject->notifyObserver(eEvent::stop);
+/**
+ * @brief Handle the step menu items
+ * @details Single step runs one cycle, for the step N cycles the number of
+ * cycles is requested from the user. The event data is only used during the
+ * notify, so it can be placed on the stack.
+ */
+void cMainFrame::onMenuStep(wxCommandEvent& event)
+{
+    uint64_t cycles = 1;
+
+    if(event.GetId() == cStepNMenuID)
+    {
+        long value = wxGetNumberFromUser("Number of clock cycles to run", "Cycles:", "Step N cycles",
+                                         100, 1, 100000000, this);
+        if(value <= 0)
+        {
+            return;
+        }
+
+        cycles = static_cast<uint64_t>(value);
+    }
+
+    _subject->notifyObserver(eEvent::step, &cycles);
+}
+
+/**
+ * @brief Handle the run for, run until and fast forward menu items
+ * @details The time is requested from the user in microseconds
+ */
+void cMainFrame::onMenuRunTime(wxCommandEvent& event)
+{
+    eEvent     timeEvent = eEvent::runUntil;
+    wxString   caption = "Run until";
+    double     microseconds = 0;
+
+    if(event.GetId() == cRunForMenuID)
+    {
+        timeEvent = eEvent::runFor;
+        caption = "Run for";
+    }
+    else if(event.GetId() == cFastForwardMenuID)
+    {
+        timeEvent = eEvent::fastForward;
+        caption = "Fast forward";
+    }
+
+    wxString value = wxGetTextFromUser("Simulation time in microseconds", caption, "1000", this);
+
+    if(value.IsEmpty() || !value.ToDouble(&microseconds) || microseconds < 0)
+    {
+        return;
+    }
+
+    simtime_t time(microseconds * 1.0_us);
+    _subject->notifyObserver(timeEvent, &time);
+}
+
+/**
+ * @brief Handle the save and restore checkpoint menu items
+ * @details The checkpoint file is requested from the user, the
+ * action itself is executed in the verilator thread.
+ */
+void cMainFrame::onMenuCheckpoint(wxCommandEvent& event)
+{
+    const bool save = event.GetId() == cSaveMenuID;
+
+    wxString fileName = wxFileSelector(save ? "Save checkpoint" : "Restore checkpoint",
+                                       wxEmptyString, "checkpoint.vlt", "vlt",
+                                       "Checkpoint files (*.vlt)|*.vlt|All files|*",
+                                       save ? wxFD_SAVE | wxFD_OVERWRITE_PROMPT : wxFD_OPEN | wxFD_FILE_MUST_EXIST,
+                                       this);
+    if(fileName.IsEmpty())
+    {
+        return;
+    }
+
+    std::string file = fileName.ToStdString();
+    _subject->notifyObserver(save ? eEvent::saveCheckpoint : eEvent::restoreCheckpoint, &file);
+}
+
+void cMainFrame::onStatusText(wxCommandEvent& event)
+{
+    SetStatusText(event.GetString());
+}
+
+/**
+ * @brief Show the run state of the board on the start button
+ * @details A running board shows the pause button, otherwise the
+ * play button is shown.
+ */
+void cMainFrame::onRunState(wxCommandEvent& event)
+{
+    const eSystemState state = static_cast<eSystemState>(event.GetInt());
+
+    _startButton->SetLabel(state == eSystemState::running ? "Pause" : "Play");
+}
+
+/**
+ * @brief Handle all pending vdb events
+ * @details Posted once per batch by the vdb event channel
+ */
+void cMainFrame::onVdbEvents(wxCommandEvent& event)
+{
+    cVdbEventChannel::instance().drain();
 }
 
 void cMainFrame::onAddVdb(wxCommandEvent& event)
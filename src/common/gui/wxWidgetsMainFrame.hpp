@@ -63,6 +63,9 @@ using namespace RoaLogic::dimensions;
 
 wxDECLARE_EVENT(wxEVT_CHANGE_FRAME, wxCommandEvent);
 wxDECLARE_EVENT(wxEVT_ADD_VDB, wxCommandEvent);
+wxDECLARE_EVENT(wxEVT_STATUS_TEXT, wxCommandEvent);
+wxDECLARE_EVENT(wxEVT_RUN_STATE, wxCommandEvent);
+wxDECLARE_EVENT(wxEVT_VDB_EVENTS, wxCommandEvent);
 
 struct sChangeFrameData : public wxClientData
 {
@@ -106,6 +109,13 @@ class cMainFrame : public wxFrame
     static const int cStartButtonID   = 100;
     static const int cResetButtonID   = 101;
     static const int cStopButtonID    = 102;
+    static const int cStepMenuID      = 110;
+    static const int cStepNMenuID     = 111;
+    static const int cRunForMenuID    = 112;
+    static const int cRunUntilMenuID  = 113;
+    static const int cFastForwardMenuID = 114;
+    static const int cSaveMenuID      = 120;
+    static const int cRestoreMenuID   = 121;
     
     std::string _myApplicationName = "Virtual development board";
     std::string _myAboutText = "Virtual development board";
@@ -139,8 +149,16 @@ class cMainFrame : public wxFrame
     void onButtonStart(wxCommandEvent& event);
     void onButtonReset(wxCommandEvent& event);
     void onButtonStop(wxCommandEvent& event);
+    void removeVdbComponents();
+
+    void onMenuStep(wxCommandEvent& event);
+    void onMenuRunTime(wxCommandEvent& event);
+    void onMenuCheckpoint(wxCommandEvent& event);
 
     void onAddVdb(wxCommandEvent& event);
+    void onStatusText(wxCommandEvent& event);
+    void onRunState(wxCommandEvent& event);
+    void onVdbEvents(wxCommandEvent& event);
 };
 
 
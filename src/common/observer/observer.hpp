@@ -48,9 +48,32 @@
 
 #include "eventDefinition.hpp"
 
+#include <cstdint>
+
 namespace RoaLogic {
 namespace observer {
 
+    /**
+     * @brief Mask of events, one bit per eEvent
+     */
+    typedef uint64_t tEventMask;
+
+    /**
+     * @brief Mask with all events set
+     */
+    constexpr tEventMask cAllEvents = ~tEventMask(0);
+
+    /**
+     * @brief Get the mask of one or more events
+     * 
+     * @return The mask with the bit of each event set
+     */
+    template <class... tEvents>
+    constexpr tEventMask eventMask(tEvents... events)
+    {
+        return ((tEventMask(1) << static_cast<unsigned>(events)) | ... | tEventMask(0));
+    }
+
     /**
      * @class cObserver
      * @author Bjorn Schouteten
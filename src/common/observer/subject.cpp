@@ -45,6 +45,7 @@
 
 #include "subject.hpp"
 #include <cstring>
+#include <thread>
 
 namespace RoaLogic {
 namespace observer {
@@ -66,51 +67,92 @@ namespace observer {
 
     }
 
+    /**
+     * @brief Wait until a snapshot has no readers anymore
+     * 
+     * @param[in] snapshot  Index of the snapshot
+     */
+    void cSubject::waitForReaders(uint8_t snapshot)
+    {
+        while(_readers[snapshot].load() != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Publish a snapshot as the current one
+     * @details Updates the combined event mask of the observers, and waits
+     * for the readers of the previous snapshot, after this no notification
+     * uses the previous list anymore.
+     * 
+     * @param[in] snapshot  Index of the snapshot to publish
+     */
+    void cSubject::publish(uint8_t snapshot)
+    {
+        const sSnapshot& list = _snapshots[snapshot];
+        tEventMask observedEvents = 0;
+
+        for(uint8_t i = 0; i < list.numObservers; i++)
+        {
+            observedEvents |= list.observers[i].mask;
+        }
+
+        _observedEvents.store(observedEvents);
+        _current.store(snapshot);
+        waitForReaders(snapshot ^ 1);
+    }
+
     /**
      * @brief register an observer
      * 
      * @details Register an observer for this subject
-     *          Loops to the array and checks if any free spot is available
+     *          Loops to the array and checks if any free spot is available.
+     *          The observer is added to a copy of the list, which is then published.
      * 
      * @param aObserver     The reference to the observer
+     * @param mask          The events the observer is interested in, all events by default
      * 
      * @return false             To many observers registered or observer is already registered
      * @return true              Succesfully registered
      */
-    bool cSubject::registerObserver(cObserver* aObserver)
+    bool cSubject::registerObserver(cObserver* aObserver, tEventMask mask)
     {
-        bool result = false;
-        bool found = false;
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        const sSnapshot& current = _snapshots[_current.load()];
 
-        if(aObserver)
+        if(!aObserver || current.numObservers >= _cMaxObservers)
         {
-            if(_observers.size() < _cMaxObservers)
-            {
-                for(auto observer : _observers)
-                {
-                    if(aObserver == observer)
-                    {
-                        found = true;
-                    }
-                }
+            return false;
+        }
 
-                if (!found)
-                {
-                    _observers.push_back(aObserver);
-                    result = true;
-                }
-            }            
+        for(uint8_t i = 0; i < current.numObservers; i++)
+        {
+            if(aObserver == current.observers[i].observer)
+            {
+                return false;
+            }
         }
 
-        return result;
+        // Copy the current list into the spare snapshot, when nobody reads it anymore
+        const uint8_t next = _current.load() ^ 1;
+        waitForReaders(next);
+
+        sSnapshot& copy = _snapshots[next];
+        copy = current;
+        copy.observers[copy.numObservers++] = sObserverEntry{aObserver, mask};
+
+        publish(next);
+        return true;
     }
 
     /**
      * @brief Remove observer from array
      * 
      * @details Remove the given observer from the list
-     *          Function goes through every registered element on the list 
-     *          when it finds the corresponding observer the entry is set to zero
+     *          The observer is removed from a copy of the list, where the following
+     *          entries are moved down so the order of registration is kept. When 
+     *          this function returns the observer is not called anymore.
      * 
      * @param[in] aObserver     The observer to remove
      * 
@@ -119,43 +161,80 @@ namespace observer {
      */
     bool cSubject::removeObserver(cObserver* aObserver)
     {
-        bool result = false;
-        uint32_t iterator = 0;
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        const sSnapshot& current = _snapshots[_current.load()];
+
+        if(!aObserver)
+        {
+            return false;
+        }
 
-        if(aObserver)
+        for(uint8_t i = 0; i < current.numObservers; i++)
         {
-            for(auto observer : _observers)
+            if(aObserver == current.observers[i].observer)
             {
-                if(aObserver == observer)
+                // Copy the current list into the spare snapshot, when nobody reads it anymore
+                const uint8_t next = _current.load() ^ 1;
+                waitForReaders(next);
+
+                sSnapshot& copy = _snapshots[next];
+                copy = current;
+
+                // Found the right observer, move the remaining ones down
+                for(uint8_t j = i + 1; j < copy.numObservers; j++)
                 {
-                    // Found the right observer, remove it and break out of the for loop
-                    _observers.erase(_observers.begin() + iterator);
-                    result = true;
-                    break;
+                    copy.observers[j - 1] = copy.observers[j];
                 }
 
-                iterator++;
+                copy.numObservers--;
+                copy.observers[copy.numObservers] = sObserverEntry{};
+
+                publish(next);
+                return true;
             }
-        }  
-        
-        return result;
+        }
+
+        return false;
     }
 
     /**
      * @brief update function
      * 
      * @details update function for the event type
-     *          Called when an event occurs, travesers through the list and calls every registerd update function
+     *          Called when an event occurs, travesers through the list and calls the update
+     *          function of every registered observer that is interested in the event.
+     * 
+     *          The notification registers itself as reader of the current snapshot. When
+     *          the snapshot was replaced in the meantime it tries again with the new one.
      * 
      * @param[in] aEvent The event what has occured
      * @param[in] data   A pointer to the data belonging to the event, when no data this shall be a nullptr
      */
     void cSubject::notifyObserver(eEvent aEvent, void* data)
     {
-        for(auto observer : _observers)
+        const tEventMask event = eventMask(aEvent);
+        uint8_t snapshot = _current.load();
+
+        _readers[snapshot].fetch_add(1);
+
+        while(_current.load() != snapshot)
         {
-            observer->notify(aEvent, data);
+            _readers[snapshot].fetch_sub(1);
+            snapshot = _current.load();
+            _readers[snapshot].fetch_add(1);
         }
+
+        const sSnapshot& list = _snapshots[snapshot];
+
+        for(uint8_t i = 0; i < list.numObservers; i++)
+        {
+            if(list.observers[i].mask & event)
+            {
+                list.observers[i].observer->notify(aEvent, data);
+            }
+        }
+
+        _readers[snapshot].fetch_sub(1);
     }
 
 }}
\ No newline at end of file
@@ -47,8 +47,9 @@
 #define SUBJECT_HPP
 
 #include "observer.hpp"
-#include <vector>
+#include <atomic>
 #include <cstdint>
+#include <mutex>
 
 namespace RoaLogic {
 namespace observer {
@@ -69,22 +70,79 @@ namespace observer {
      * When an event occurs, the notifyObserver shall be called with the event type.
      * Optionally data can be passed with this function.
      * 
+     * Each observer registers with a mask of the events it is interested in, see
+     * eventMask(). Only the observers with the bit of the event set are notified.
+     * The observers are stored in a fixed array within the subject, so notifying
+     * doesn't allocate or follow a pointer to heap storage.
+     * 
+     * Observers can be registered and removed from another thread while a 
+     * notification is in progress, without a lock in notifyObserver(). This
+     * uses a read-copy-update scheme with two snapshots of the observer list. 
+     * A notification reads the current snapshot and counts itself as reader 
+     * of that snapshot. A change copies the current snapshot into the other 
+     * one, modifies the copy and publishes it as current. It then waits until
+     * all readers of the old snapshot are done, so when removeObserver() 
+     * returns the observer is not called anymore and may be deleted.
+     * 
+     * hasObservers() tells if any observer is interested in an event, so that a
+     * subject can skip the work to produce the data of an event nobody uses.
+     * 
+     * @attention An observer shall not be registered or removed from within a
+     * notification of the same subject, the change would wait for itself.
+     * 
      */
     class cSubject
     {
-        protected:
-        std::vector<cObserver*> _observers;
-        
         public:
         static const uint8_t _cMaxObservers = 10;
 
+        protected:
+        /**
+         * @brief A registered observer and its event mask
+         */
+        struct sObserverEntry
+        {
+            cObserver* observer;    //!< The registered observer
+            tEventMask mask;        //!< Events the observer is interested in
+        };
+
+        /**
+         * @brief A snapshot of the registered observers
+         */
+        struct sSnapshot
+        {
+            sObserverEntry observers[_cMaxObservers] = {};  //!< Registered observers, in order of registration
+            uint8_t numObservers = 0;                       //!< Number of registered observers
+        };
+
+        sSnapshot _snapshots[2];                    //!< The current and the spare snapshot
+        std::atomic<uint8_t> _current{0};           //!< Index of the current snapshot
+        std::atomic<uint32_t> _readers[2] = {};     //!< Number of notifications reading each snapshot
+        std::mutex _writeMutex;                     //!< Serializes the changes to the observer list
+        std::atomic<tEventMask> _observedEvents{0}; //!< Combined event mask of all registered observers
+
+        void waitForReaders(uint8_t snapshot);
+        void publish(uint8_t snapshot);
+        
+        public:
         cSubject(void);
         ~cSubject(void);
 
-        bool registerObserver(cObserver* aObserver);
+        bool registerObserver(cObserver* aObserver, tEventMask mask = cAllEvents);
         bool removeObserver(cObserver* aObserver);
 
         void notifyObserver(eEvent aEvent, void* data = nullptr);
+
+        /**
+         * @brief Check if any observer is interested in an event
+         * 
+         * @param[in] aEvent    The event
+         * @return true when at least one registered observer has the event in its mask
+         */
+        bool hasObservers(eEvent aEvent) const
+        {
+            return (_observedEvents.load(std::memory_order_relaxed) & eventMask(aEvent)) != 0;
+        }
     };
 
 }}
@@ -0,0 +1,240 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Observer stress test C++ file                                //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "subject.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file subjectStress.cpp
+ * @brief Stress test of the observer list of cSubject
+ * @version 0.1
+ * @date 16-oct-2026
+ * 
+ * @details One thread notifies a subject with millions of events, while other
+ * threads register and remove observers all the time. The test checks that:
+ * - an observer that stays registered receives every event of its mask.
+ * - an observer never receives an event outside its mask.
+ * - an observer is not called anymore once removeObserver() returned.
+ * - hasObservers() is set while an observer of the event is registered.
+ * 
+ * Build and run with "make" in this directory, "make TSAN=1" runs it with
+ * the thread sanitizer. The number of events is the first argument.
+ */
+
+using namespace RoaLogic::observer;
+
+namespace
+{
+    const eEvent cEventA = eEvent::ledBrightness;       //!< Event notified on even loops
+    const eEvent cEventB = eEvent::sevenSegmentUpdate;  //!< Event notified on odd loops
+
+    /**
+     * @brief Observer that counts its events and checks its mask
+     */
+    class cCountingObserver : public cObserver
+    {
+        private:
+        tEventMask _mask;
+
+        public:
+        std::atomic<uint64_t> count{0};         //!< Number of received events
+        std::atomic<uint64_t> wrongEvents{0};   //!< Events outside the mask
+        std::atomic<uint64_t> lateEvents{0};    //!< Events received while not registered
+        std::atomic<bool> registered{false};    //!< Set before registering, cleared after removing
+
+        cCountingObserver(tEventMask mask) : _mask(mask) {}
+
+        tEventMask getMask() const { return _mask; }
+
+        void notify(eEvent aEvent, void* data)
+        {
+            count.fetch_add(1, std::memory_order_relaxed);
+
+            if(!(eventMask(aEvent) & _mask))
+            {
+                wrongEvents.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            if(!registered.load(std::memory_order_relaxed))
+            {
+                lateEvents.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /**
+     * @brief Register and remove a set of observers until stopped
+     * 
+     * @return The number of register and remove cycles
+     */
+    uint64_t churn(cSubject& subject, std::vector<cCountingObserver*> observers, 
+                   const std::atomic<bool>& stop, std::atomic<uint64_t>& failures)
+    {
+        uint64_t cycles = 0;
+
+        while(!stop.load(std::memory_order_relaxed))
+        {
+            for(cCountingObserver* observer : observers)
+            {
+                observer->registered.store(true);
+
+                if(!subject.registerObserver(observer, observer->getMask()))
+                {
+                    failures.fetch_add(1);
+                }
+            }
+
+            for(cCountingObserver* observer : observers)
+            {
+                if(!subject.removeObserver(observer))
+                {
+                    failures.fetch_add(1);
+                }
+
+                // From here on the observer shall not be called anymore
+                observer->registered.store(false);
+            }
+
+            cycles++;
+        }
+
+        return cycles;
+    }
+
+    bool check(bool condition, const std::string& message)
+    {
+        if(!condition)
+        {
+            std::cout << "FAIL: " << message << "\n";
+        }
+
+        return condition;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint64_t numEvents = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 5000000;
+
+    cSubject subject;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> failures{0};
+    uint64_t numA = 0;
+    uint64_t numB = 0;
+    bool ok = true;
+
+    // Stay registered during the whole test
+    cCountingObserver permanentAll(cAllEvents);
+    cCountingObserver permanentA(eventMask(cEventA));
+    permanentAll.registered = true;
+    permanentA.registered = true;
+    subject.registerObserver(&permanentAll, permanentAll.getMask());
+    subject.registerObserver(&permanentA, permanentA.getMask());
+
+    // Registered and removed all the time, 2 + 2 * 4 stays within _cMaxObservers
+    cCountingObserver churnA(eventMask(cEventA)), churnB(eventMask(cEventB));
+    cCountingObserver churnAB(eventMask(cEventA, cEventB)), churnNone(0);
+    cCountingObserver churnA2(eventMask(cEventA)), churnB2(eventMask(cEventB));
+    cCountingObserver churnAB2(eventMask(cEventA, cEventB)), churnAll(cAllEvents);
+
+    uint64_t cycles1 = 0;
+    uint64_t cycles2 = 0;
+    std::thread churn1([&]{ cycles1 = churn(subject, {&churnA, &churnB, &churnAB, &churnNone}, stop, failures); });
+    std::thread churn2([&]{ cycles2 = churn(subject, {&churnA2, &churnB2, &churnAB2, &churnAll}, stop, failures); });
+
+    for(uint64_t i = 0; i < numEvents; i++)
+    {
+        if(i & 1)
+        {
+            subject.notifyObserver(cEventB);
+            numB++;
+        }
+        else
+        {
+            subject.notifyObserver(cEventA);
+            numA++;
+        }
+
+        if(!subject.hasObservers(cEventA))
+        {
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    stop = true;
+    churn1.join();
+    churn2.join();
+
+    std::cout << numEvents << " events, " << cycles1 + cycles2 << " register/remove cycles\n";
+
+    ok &= check(failures == 0, "register, remove or hasObservers() failed " + std::to_string(failures) + " times");
+    ok &= check(permanentAll.count == numEvents, "permanent observer missed events");
+    ok &= check(permanentA.count == numA, "permanent observer of event A missed events");
+    ok &= check(cycles1 > 0 && cycles2 > 0, "no register/remove cycles");
+
+    for(cCountingObserver* observer : {&permanentAll, &permanentA, &churnA, &churnB, &churnAB, &churnNone,
+                                       &churnA2, &churnB2, &churnAB2, &churnAll})
+    {
+        ok &= check(observer->wrongEvents == 0, "observer received an event outside its mask");
+        ok &= check(observer->lateEvents == 0, "observer called after removeObserver() returned");
+    }
+
+    ok &= check(churnNone.count == 0, "observer without events was called");
+
+    subject.removeObserver(&permanentAll);
+    subject.removeObserver(&permanentA);
+    ok &= check(!subject.hasObservers(cEventA), "hasObservers() set without an observer");
+
+    std::cout << (ok ? "PASS" : "FAILED") << "\n";
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
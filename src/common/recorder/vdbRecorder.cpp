@@ -0,0 +1,417 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Virtual development board event recorder                     //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "vdbRecorder.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace RoaLogic {
+namespace recorder {
+
+    /**
+     * @brief Append a variable length integer to a buffer
+     */
+    static void appendValue(std::vector<uint8_t>& buffer, uint64_t value)
+    {
+        while(value >= 0x80)
+        {
+            buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+
+        buffer.push_back(static_cast<uint8_t>(value));
+    }
+
+    /**
+     * @brief Constructor
+     * @details Observes a vdb component for the recorder
+     * 
+     * @param[in] recorder      The recorder
+     * @param[in] component     The recorded component
+     * @param[in] channel       The channel of the component
+     */
+    cVdbRecorder::cTap::cTap(cVdbRecorder* recorder, cVDBCommon* component, uint16_t channel) :
+        _recorder(recorder),
+        _component(component),
+        _channel(channel)
+    {
+        _component->registerObserver(this);
+    }
+
+    /**
+     * @brief Destructor
+     */
+    cVdbRecorder::cTap::~cTap()
+    {
+        _component->removeObserver(this);
+    }
+
+    /**
+     * @brief Record an event of the component
+     * @note Runs in the verilator thread context
+     */
+    void cVdbRecorder::cTap::notify(eEvent aEvent, void* data)
+    {
+        uint32_t value;
+
+        if(_component->encodePayload(data, value))
+        {
+            _recorder->record(_channel, aEvent, value);
+        }
+    }
+
+    /**
+     * @brief Constructor
+     * 
+     * @param[in] timeInterface     The time of the recorded events
+     */
+    cVdbRecorder::cVdbRecorder(cTimeInterface* timeInterface) :
+        _timeInterface(timeInterface)
+    {
+        assert(timeInterface != nullptr);
+    }
+
+    /**
+     * @brief Destructor
+     * @details Closes the recording
+     */
+    cVdbRecorder::~cVdbRecorder()
+    {
+        close();
+    }
+
+    /**
+     * @brief Open a recording
+     * @details Writes the header and starts the writer thread.
+     * 
+     * @param[in] fileName  The file to record to, an existing file is overwritten
+     * 
+     * @return true when the file is opened
+     */
+    bool cVdbRecorder::open(std::string fileName)
+    {
+        close();
+
+        _file.open(fileName, std::ios::binary | std::ios::trunc);
+
+        if(!_file.is_open())
+        {
+            ERROR << "Can't open recording " << fileName << "\n";
+            return false;
+        }
+
+        _file.write(cMagic, sizeof(cMagic));
+        _file.put(static_cast<char>(cVersion));
+
+        _fileName = fileName;
+        _bytes = sizeof(cMagic) + 1;
+        _recorded = 0;
+        _dropped = 0;
+        _running = true;
+        _writer = std::thread(&cVdbRecorder::writeRecords, this);
+
+        INFO << "Recording vdb events to " << fileName << "\n";
+
+        return true;
+    }
+
+    /**
+     * @brief Attach a vdb component
+     * @details The component gets the next channel number, the components
+     * shall be attached in the same order for the replay.
+     * 
+     * @param[in] component     The component to record
+     */
+    void cVdbRecorder::attach(cVDBCommon* component)
+    {
+        if(component)
+        {
+            _taps.push_back(std::make_unique<cTap>(this, component, static_cast<uint16_t>(_taps.size())));
+        }
+    }
+
+    /**
+     * @brief Close the recording
+     * @details Detaches the components, writes the remaining records and 
+     * stops the writer thread.
+     */
+    void cVdbRecorder::close()
+    {
+        _taps.clear();
+
+        if(_running.exchange(false))
+        {
+            _writer.join();
+            _file.close();
+
+            INFO << "Recorded " << _recorded << " vdb events (" << _bytes << " bytes) to " << _fileName 
+                 << ", " << _dropped << " events dropped\n";
+        }
+    }
+
+    /**
+     * @brief Place a record in the ring
+     * @note Runs in the verilator thread context
+     */
+    void cVdbRecorder::record(uint16_t channel, eEvent aEvent, uint32_t value)
+    {
+        if(!_running.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        sVdbRecord record{static_cast<uint64_t>(std::llround(_timeInterface->getTime().ms() * 1.0e9)),
+                          channel, static_cast<uint8_t>(aEvent), value};
+        tProducerLock lock(_producerMutex);
+
+        if(_ring.push(record))
+        {
+            _recorded.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Writer thread
+     * @details Encodes the records in the ring and writes them into the 
+     * file, until the recording is closed and the ring is empty.
+     */
+    void cVdbRecorder::writeRecords()
+    {
+        std::vector<uint8_t> buffer;
+        uint64_t lastTimePs = 0;
+
+        while(_running.load(std::memory_order_acquire))
+        {
+            flush(buffer, lastTimePs);
+            std::this_thread::sleep_for(cFlushInterval);
+        }
+
+        flush(buffer, lastTimePs);
+    }
+
+    /**
+     * @brief Write all records in the ring into the file
+     * 
+     * @param[in,out] buffer        Encoding buffer
+     * @param[in,out] lastTimePs    Time of the last written record
+     */
+    void cVdbRecorder::flush(std::vector<uint8_t>& buffer, uint64_t& lastTimePs)
+    {
+        sVdbRecord record;
+
+        buffer.clear();
+
+        while(_ring.pop(record))
+        {
+            // The time can move backwards, e.g. after restoring a checkpoint
+            if(record.timePs < lastTimePs)
+            {
+                lastTimePs = 0;
+                appendValue(buffer, 0);
+                buffer.push_back(0xff);
+            }
+
+            appendValue(buffer, record.timePs - lastTimePs);
+            buffer.push_back(record.event);
+            appendValue(buffer, record.channel);
+            appendValue(buffer, record.value);
+            lastTimePs = record.timePs;
+        }
+
+        if(!buffer.empty())
+        {
+            _file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+            _bytes += buffer.size();
+        }
+    }
+
+
+    /**
+     * @brief Constructor
+     */
+    cVdbReplay::cVdbReplay(void)
+    {
+    }
+
+    /**
+     * @brief Destructor
+     */
+    cVdbReplay::~cVdbReplay(void)
+    {
+    }
+
+    /**
+     * @brief Open a recording
+     * 
+     * @param[in] fileName  The recording
+     * 
+     * @return true when the file is a recording of a supported version
+     */
+    bool cVdbReplay::open(std::string fileName)
+    {
+        char magic[sizeof(cVdbRecorder::cMagic)];
+
+        _file.open(fileName, std::ios::binary);
+
+        if(!_file.is_open())
+        {
+            ERROR << "Can't open recording " << fileName << "\n";
+            return false;
+        }
+
+        _file.read(magic, sizeof(magic));
+
+        if(!_file || !std::equal(magic, magic + sizeof(magic), cVdbRecorder::cMagic) || 
+           _file.get() != cVdbRecorder::cVersion)
+        {
+            ERROR << fileName << " is not a vdb recording\n";
+            _file.close();
+            return false;
+        }
+
+        _timePs = 0;
+
+        return true;
+    }
+
+    /**
+     * @brief Attach a vdb component
+     * @details The component gets the next channel number
+     * 
+     * @param[in] component     The component to replay
+     */
+    void cVdbReplay::attach(cVDBCommon* component)
+    {
+        _components.push_back(component);
+    }
+
+    /**
+     * @brief Read a variable length integer
+     */
+    bool cVdbReplay::readValue(uint64_t& value)
+    {
+        int byte;
+        unsigned shift = 0;
+
+        value = 0;
+
+        do
+        {
+            byte = _file.get();
+
+            if(byte == std::char_traits<char>::eof() || shift > 63)
+            {
+                return false;
+            }
+
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            shift += 7;
+        } while(byte & 0x80);
+
+        return true;
+    }
+
+    /**
+     * @brief Read the next record
+     * 
+     * @param[out] record   The record
+     * 
+     * @return false at the end of the recording
+     */
+    bool cVdbReplay::read(sVdbRecord& record)
+    {
+        uint64_t delta, channel, value;
+        int event;
+
+        while(readValue(delta))
+        {
+            event = _file.get();
+
+            // Time reset marker, written when the time moved backwards
+            if(delta == 0 && event == 0xff)
+            {
+                _timePs = 0;
+                continue;
+            }
+
+            if(event == std::char_traits<char>::eof() || !readValue(channel) || !readValue(value))
+            {
+                break;
+            }
+
+            _timePs += delta;
+
+            record.timePs = _timePs;
+            record.channel = static_cast<uint16_t>(channel);
+            record.event = static_cast<uint8_t>(event);
+            record.value = static_cast<uint32_t>(value);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Notify the observers of the component of a record
+     * 
+     * @param[in] record    The record
+     */
+    void cVdbReplay::apply(const sVdbRecord& record)
+    {
+        if(record.channel < _components.size() && _components[record.channel])
+        {
+            _components[record.channel]->replayPayload(static_cast<eEvent>(record.event), record.value);
+        }
+    }
+
+}}
@@ -0,0 +1,221 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Virtual development board event recorder                     //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef VDB_RECORDER_HPP
+#define VDB_RECORDER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "testbench.hpp"
+#include "vdbCommon.hpp"
+#include "spscRing.hpp"
+
+namespace RoaLogic {
+    using namespace testbench;
+    using namespace observer;
+    using namespace vdb;
+namespace recorder {
+
+    /**
+     * @struct sVdbRecord
+     * @brief Recorded event of a vdb component
+     */
+    struct sVdbRecord
+    {
+        uint64_t timePs;    //!< Simulation time of the event in picoseconds
+        uint16_t channel;   //!< Channel of the component, the order in which it is attached
+        uint8_t  event;     //!< The event, see eEvent
+        uint32_t value;     //!< The encoded event data, see cVDBCommon::encodePayload()
+    };
+
+    /**
+     * @class cVdbRecorder
+     * @brief Records the events of vdb components into a file
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details The recorder is attached as observer to the vdb components, 
+     * each component gets a channel number in the order in which it is 
+     * attached. Every event whose data can be encoded in 32 bits is stored
+     * as a record of the simulation time, the channel, the event and the
+     * value. Other events, like the frames of the VGA monitor, are not 
+     * recorded.
+     * 
+     * The verilator thread only pushes the records into a lock-free ring, a
+     * background thread writes them into the file. When the ring is full 
+     * the record is dropped and counted, the simulation never waits for the
+     * file.
+     * 
+     * The file starts with cMagic and cVersion, followed by the records. A 
+     * record holds the time since the previous record, the event, the channel
+     * and the value. The time, channel and value are stored as variable length
+     * integers (7 bits per byte, the MSB marks that another byte follows), so
+     * most records take 4 to 6 bytes. When the time moves backwards, e.g. after
+     * restoring a checkpoint, a marker with a time of 0 and event 0xff resets
+     * the time to 0.
+     * 
+     * A recorded file is played back with cVdbReplay.
+     * 
+     * @note The ring has a single producer. When the model is verilated with 
+     * multiple threads (VDB_SIM_THREADS) the producers are serialized with a
+     * mutex, in a single threaded build the lock compiles away.
+     */
+    class cVdbRecorder
+    {
+        public:
+        static constexpr char    cMagic[4] = {'V', 'D', 'B', 'R'};  //!< First bytes of a recording
+        static const uint8_t     cVersion = 1;                      //!< Version of the file format
+        static const size_t      cCapacity = 65536;                 //!< Maximum number of records waiting to be written
+
+        private:
+#ifdef VDB_SIM_THREADS
+        typedef std::mutex                  tProducerMutex;
+        typedef std::lock_guard<std::mutex> tProducerLock;
+#else
+        struct sNoLock
+        {
+            sNoLock() {}
+            template <class T> explicit sNoLock(T&) {}
+        };
+        typedef sNoLock tProducerMutex;
+        typedef sNoLock tProducerLock;
+#endif
+
+        /**
+         * @class cTap
+         * @brief Observer of one recorded vdb component
+         */
+        class cTap : public cObserver
+        {
+            private:
+            cVdbRecorder* _recorder;
+            cVDBCommon*   _component;
+            uint16_t      _channel;
+
+            public:
+            cTap(cVdbRecorder* recorder, cVDBCommon* component, uint16_t channel);
+            ~cTap();
+
+            void notify(eEvent aEvent, void* data);
+        };
+
+        static constexpr std::chrono::milliseconds cFlushInterval{10};  //!< Time the writer sleeps when the ring is empty
+
+        cTimeInterface* _timeInterface;             //!< Time of the recorded events
+        std::vector<std::unique_ptr<cTap>> _taps;   //!< Observers of the attached components
+
+        GUI::cSpscRing<sVdbRecord, cCapacity> _ring;   //!< Records waiting to be written
+        tProducerMutex _producerMutex;              //!< Serializes the producers
+
+        std::ofstream _file;                        //!< The recording
+        std::string   _fileName;                    //!< Name of the recording
+        std::thread   _writer;                      //!< Writes the records into the file
+        std::atomic<bool> _running{false};          //!< The writer is running
+
+        std::atomic<uint64_t> _recorded{0};         //!< Number of records placed in the ring
+        std::atomic<uint64_t> _dropped{0};          //!< Number of records lost because the ring was full
+        uint64_t _bytes = 0;                        //!< Number of bytes written, only used by the writer
+
+        void record(uint16_t channel, eEvent aEvent, uint32_t value);
+        void writeRecords();
+        void flush(std::vector<uint8_t>& buffer, uint64_t& lastTimePs);
+
+        public:
+        cVdbRecorder(cTimeInterface* timeInterface);
+        ~cVdbRecorder();
+
+        bool open(std::string fileName);
+        void attach(cVDBCommon* component);
+        void close();
+    };
+
+    /**
+     * @class cVdbReplay
+     * @brief Plays back a recording of cVdbRecorder
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details The components shall be attached in the same order as they 
+     * were attached to the recorder. Each record read with read() is passed 
+     * to the component of its channel with apply(), which notifies the 
+     * observers of the component as if the event came from the design. The
+     * verilated model is not evaluated, so a recording can be reviewed at 
+     * any speed.
+     */
+    class cVdbReplay
+    {
+        private:
+        std::ifstream _file;                        //!< The recording
+        std::vector<cVDBCommon*> _components;       //!< The attached components, indexed by channel
+        uint64_t _timePs = 0;                       //!< Time of the last record
+
+        bool readValue(uint64_t& value);
+
+        public:
+        cVdbReplay(void);
+        ~cVdbReplay(void);
+
+        bool open(std::string fileName);
+        void attach(cVDBCommon* component);
+        bool read(sVdbRecord& record);
+        void apply(const sVdbRecord& record);
+
+        /**
+         * @brief Get the simulation time of a record
+         */
+        static simtime_t getTime(const sVdbRecord& record) { return simtime_t(record.timePs * 1.0e-12L); }
+    };
+
+}}
+
+#endif // VDB_RECORDER_HPP
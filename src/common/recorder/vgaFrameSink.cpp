@@ -0,0 +1,387 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Virtual Devboard VGA frame sink                              //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "vgaFrameSink.hpp"
+#include "vgaPixelConverter.hpp"
+#include "log.hpp"
+
+#include <cstdio>
+
+namespace RoaLogic {
+namespace recorder {
+
+    /**
+     * @brief Constructor
+     */
+    cVgaFrameSink::cVgaFrameSink(void)
+    {
+    }
+
+    /**
+     * @brief Destructor
+     * @details Writes the remaining frames
+     */
+    cVgaFrameSink::~cVgaFrameSink(void)
+    {
+        close();
+    }
+
+    /**
+     * @brief Open the sink
+     * @details The format follows from the file name, see the class 
+     * description. Starts the encoder thread.
+     * 
+     * @param[in] fileName  The stream, or the base name of the frame files
+     * @param[in] first     First written frame
+     * @param[in] last      Last written frame
+     * @param[in] every     Write every n-th frame from the first frame on
+     * 
+     * @return true when the sink is opened
+     */
+    bool cVgaFrameSink::open(std::string fileName, uint32_t first, uint32_t last, uint32_t every)
+    {
+        const std::string y4m = ".y4m";
+        const std::string ppm = ".ppm";
+
+        close();
+
+        if(fileName.size() > y4m.size() && fileName.compare(fileName.size() - y4m.size(), y4m.size(), y4m) == 0)
+        {
+            _stream.open(fileName, std::ios::binary | std::ios::trunc);
+
+            if(!_stream.is_open())
+            {
+                ERROR << "Can't open VGA stream " << fileName << "\n";
+                return false;
+            }
+
+            _format = eFormat::y4m;
+            _fileName = fileName;
+        }
+        else
+        {
+            // The frame number is placed before the extension
+            if(fileName.size() > ppm.size() && fileName.compare(fileName.size() - ppm.size(), ppm.size(), ppm) == 0)
+            {
+                fileName.erase(fileName.size() - ppm.size());
+            }
+
+            _format = eFormat::ppm;
+            _fileName = fileName;
+        }
+
+        _first = first;
+        _last = last;
+        _every = every != 0 ? every : 1;
+        _frameNumber = 0;
+        _done = false;
+        _streamWidth = 0;
+        _streamHeight = 0;
+        _stalls = 0;
+        _written = 0;
+        _skipped = 0;
+        _bytes = 0;
+
+        _free.clear();
+        _full.clear();
+
+        for(sBuffer& buffer : _buffers)
+        {
+            _free.push_back(&buffer);
+        }
+
+        _stop = false;
+        _running = true;
+        _encoder = std::thread(&cVgaFrameSink::encodeFrames, this);
+
+        INFO << "Writing VGA frames to " << (_format == eFormat::y4m ? _fileName : _fileName + "_<frame>.ppm") << "\n";
+
+        return true;
+    }
+
+    /**
+     * @brief Attach the VGA monitor
+     * @details Only the vgaDataReady event is observed
+     * 
+     * @param[in] monitor   The VGA monitor to write the frames of
+     */
+    void cVgaFrameSink::attach(cVdbVGAMonitor* monitor)
+    {
+        if(_monitor)
+        {
+            _monitor->removeObserver(this);
+        }
+
+        _monitor = monitor;
+
+        if(_monitor)
+        {
+            _monitor->registerObserver(this, eventMask(eEvent::vgaDataReady));
+        }
+    }
+
+    /**
+     * @brief Close the sink
+     * @details Detaches the VGA monitor, writes the remaining frames and 
+     * stops the encoder thread.
+     * 
+     * @note Shall be called from the verilator thread, or when the model
+     * isn't evaluated
+     */
+    void cVgaFrameSink::close()
+    {
+        attach(nullptr);
+
+        if(_running)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+
+            _filled.notify_one();
+            _encoder.join();
+            _running = false;
+
+            if(_stream.is_open())
+            {
+                _stream.close();
+            }
+
+            INFO << "Wrote " << _written << " VGA frames (" << _bytes << " bytes), " 
+                 << _stalls << " simulation stalls, " << _skipped << " frames skipped\n";
+        }
+    }
+
+    /**
+     * @brief Check if a frame is written
+     */
+    bool cVgaFrameSink::selected(uint32_t number) const
+    {
+        return number >= _first && number <= _last && (number - _first) % _every == 0;
+    }
+
+    /**
+     * @brief Handle a frame of the VGA monitor
+     * @details A selected frame is copied into a free buffer and passed to
+     * the encoder. When no buffer is free this waits for the encoder. The 
+     * sink is done when the last frame is received.
+     * 
+     * @note Runs in the verilator thread context
+     */
+    void cVgaFrameSink::notify(eEvent aEvent, void* data)
+    {
+        sBuffer* buffer;
+
+        if(aEvent != eEvent::vgaDataReady || !_running)
+        {
+            return;
+        }
+
+        const uint32_t number = _frameNumber++;
+
+        if(number >= _last)
+        {
+            _done = true;
+        }
+
+        if(!selected(number))
+        {
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if(_free.empty())
+            {
+                _stalls++;
+                _freed.wait(lock, [this]{ return !_free.empty(); });
+            }
+
+            buffer = _free.back();
+            _free.pop_back();
+        }
+
+        // The buffer is owned by this thread until it is queued
+        buffer->number = number;
+        buffer->frame.copy(cVdbVGAMonitor::payload(data));
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _full.push_back(buffer);
+        }
+
+        _filled.notify_one();
+    }
+
+    /**
+     * @brief Encoder thread
+     * @details Writes the queued frames in order, until the sink is closed
+     * and the queue is empty.
+     */
+    void cVgaFrameSink::encodeFrames()
+    {
+        while(true)
+        {
+            sBuffer* buffer;
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _filled.wait(lock, [this]{ return _stop || !_full.empty(); });
+
+                if(_full.empty())
+                {
+                    break;
+                }
+
+                buffer = _full.front();
+                _full.pop_front();
+            }
+
+            if(_format == eFormat::y4m)
+            {
+                writeY4m(*buffer);
+            }
+            else
+            {
+                writePpm(*buffer);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _free.push_back(buffer);
+            }
+
+            _freed.notify_one();
+        }
+    }
+
+    /**
+     * @brief Write a frame into a binary PPM file
+     */
+    void cVgaFrameSink::writePpm(const sBuffer& buffer)
+    {
+        const sVgaFrame& frame = buffer.frame;
+        char number[16];
+
+        std::snprintf(number, sizeof(number), "_%06u.ppm", buffer.number);
+
+        std::string fileName = _fileName + number;
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+
+        if(!file.is_open())
+        {
+            ERROR << "Can't open VGA frame " << fileName << "\n";
+            return;
+        }
+
+        std::string header = "P6\n" + std::to_string(frame.width) + " " + std::to_string(frame.height) + "\n255\n";
+
+        _data.resize(frame.pixels.size() * 3);
+        cVgaPixelConverter::convert(frame.pixels.data(), _data.data(), frame.pixels.size());
+
+        file.write(header.data(), header.size());
+        file.write(reinterpret_cast<const char*>(_data.data()), _data.size());
+
+        _written++;
+        _bytes += header.size() + _data.size();
+    }
+
+    /**
+     * @brief Append a frame to the YUV4MPEG2 stream
+     * @details The stream header is written with the first frame. The 
+     * pixels are converted to limited range BT.601 Y, Cb and Cr planes.
+     */
+    void cVgaFrameSink::writeY4m(const sBuffer& buffer)
+    {
+        const sVgaFrame& frame = buffer.frame;
+        const size_t numPixels = frame.pixels.size();
+        const std::string frameHeader = "FRAME\n";
+
+        if(_streamWidth == 0)
+        {
+            // The frame rate of the stream is the rate of the written frames
+            std::string header = "YUV4MPEG2 W" + std::to_string(frame.width) + " H" + std::to_string(frame.height) +
+                                 " F" + std::to_string(frame.frameRate != 0 ? frame.frameRate : 60) + ":" + 
+                                 std::to_string(_every) + " Ip A1:1 C444\n";
+
+            _stream.write(header.data(), header.size());
+            _bytes += header.size();
+            _streamWidth = frame.width;
+            _streamHeight = frame.height;
+        }
+
+        if(frame.width != _streamWidth || frame.height != _streamHeight)
+        {
+            _skipped++;
+            return;
+        }
+
+        _data.resize(numPixels * 3);
+
+        uint8_t* y  = _data.data();
+        uint8_t* cb = y + numPixels;
+        uint8_t* cr = cb + numPixels;
+
+        for(size_t i = 0; i < numPixels; i++)
+        {
+            const int red   = frame.pixels[i].red;
+            const int green = frame.pixels[i].green;
+            const int blue  = frame.pixels[i].blue;
+
+            y[i]  = static_cast<uint8_t>((( 66 * red + 129 * green +  25 * blue + 128) >> 8) +  16);
+            cb[i] = static_cast<uint8_t>(((-38 * red -  74 * green + 112 * blue + 128) >> 8) + 128);
+            cr[i] = static_cast<uint8_t>(((112 * red -  94 * green -  18 * blue + 128) >> 8) + 128);
+        }
+
+        _stream.write(frameHeader.data(), frameHeader.size());
+        _stream.write(reinterpret_cast<const char*>(_data.data()), _data.size());
+
+        _written++;
+        _bytes += frameHeader.size() + _data.size();
+    }
+
+}}
@@ -0,0 +1,164 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Virtual Devboard VGA frame sink header                       //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef VGA_FRAME_SINK_HPP
+#define VGA_FRAME_SINK_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vdbVGAMonitor.hpp"
+
+namespace RoaLogic {
+    using namespace observer;
+    using namespace vdb;
+namespace recorder {
+
+    /**
+     * @class cVgaFrameSink
+     * @brief Writes the frames of a VGA monitor into files
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details The sink observes the vgaDataReady event of a VGA monitor, 
+     * so it also works without a GUI. The frames are numbered from 0 in the
+     * order they are received. A selection of them, from the first up to the
+     * last frame and every n-th frame in between, is written:
+     * - into a single YUV4MPEG2 stream when the file name ends with .y4m.
+     *   The stream is 4:4:4, with the resolution and frame rate of the first
+     *   written frame. Frames with another resolution are skipped.
+     * - into a binary PPM file per frame otherwise, named <name>_<number>.ppm.
+     * 
+     * The verilator thread only copies a selected frame into one of 
+     * cNumBuffers buffers, a background thread encodes and writes it. When 
+     * all buffers are in use the verilator thread waits for the encoder, so 
+     * no selected frame is lost. These stalls are counted.
+     * 
+     * While the sink is attached the VGA monitor keeps capturing frames, 
+     * also the frames that are not selected. After the last frame isDone()
+     * returns true, the owner shall then close the sink between two ticks.
+     * The sink can't detach itself, an observer can't be removed within a
+     * notification of the same subject.
+     */
+    class cVgaFrameSink : public cObserver
+    {
+        public:
+        static const size_t cNumBuffers = 4;    //!< Number of frames waiting to be written
+
+        enum class eFormat
+        {
+            ppm,    //!< A PPM file per frame
+            y4m     //!< One YUV4MPEG2 stream
+        };
+
+        private:
+        /**
+         * @brief A frame waiting to be written
+         */
+        struct sBuffer
+        {
+            uint32_t  number;   //!< Number of the frame
+            sVgaFrame frame;    //!< Copy of the frame
+        };
+
+        cVdbVGAMonitor* _monitor = nullptr;     //!< The observed VGA monitor
+        std::string _fileName;                  //!< The stream, or the base name of the frame files
+        eFormat  _format = eFormat::ppm;        //!< Output format
+        uint32_t _first = 0;                    //!< First written frame
+        uint32_t _last = UINT32_MAX;            //!< Last written frame
+        uint32_t _every = 1;                    //!< Distance between two written frames
+        uint32_t _frameNumber = 0;              //!< Number of the next frame, only used by the verilator thread
+        bool _done = false;                     //!< The last frame is received, only used by the verilator thread
+
+        sBuffer _buffers[cNumBuffers];          //!< The frame buffers
+        std::vector<sBuffer*> _free;            //!< Buffers available to the verilator thread
+        std::deque<sBuffer*> _full;             //!< Buffers waiting for the encoder, oldest first
+        std::mutex _mutex;                      //!< Protects _free, _full and _stop
+        std::condition_variable _freed;         //!< Signals a buffer in _free
+        std::condition_variable _filled;        //!< Signals a buffer in _full, or _stop
+        bool _stop = false;                     //!< The encoder stops when _full is empty
+        std::thread _encoder;                   //!< Encodes and writes the frames
+        bool _running = false;                  //!< The encoder is running
+
+        uint64_t _stalls = 0;                   //!< Number of times the verilator thread waited for a buffer
+        std::ofstream _stream;                  //!< The YUV4MPEG2 stream, only used by the encoder
+        uint32_t _streamWidth = 0;              //!< Width of the stream
+        uint32_t _streamHeight = 0;             //!< Height of the stream
+        std::vector<uint8_t> _data;             //!< Encoded frame, only used by the encoder
+        uint64_t _written = 0;                  //!< Number of written frames, only used by the encoder
+        uint64_t _skipped = 0;                  //!< Number of frames with another resolution than the stream
+        uint64_t _bytes = 0;                    //!< Number of bytes written, only used by the encoder
+
+        bool selected(uint32_t number) const;
+        void encodeFrames();
+        void writePpm(const sBuffer& buffer);
+        void writeY4m(const sBuffer& buffer);
+
+        public:
+        cVgaFrameSink(void);
+        ~cVgaFrameSink(void);
+
+        bool open(std::string fileName, uint32_t first, uint32_t last, uint32_t every);
+        void attach(cVdbVGAMonitor* monitor);
+        void close();
+
+        void notify(eEvent aEvent, void* data);
+
+        /**
+         * @brief Check if the last frame is received
+         * @note Shall be called from the verilator thread
+         */
+        bool isDone() const { return _done; }
+    };
+
+}}
+
+#endif // VGA_FRAME_SINK_HPP
@@ -0,0 +1,237 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Wall clock pacer implementation                              //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "pacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace RoaLogic {
+namespace control {
+
+    /**
+     * @brief Construct a new pacer
+     * @details Pacing is disabled by default
+     * 
+     * @param[in] runControl    Run control which can end a wait early, nullptr sleeps uninterrupted
+     */
+    cPacer::cPacer(cRunControl* runControl) :
+        _runControl(runControl)
+    {
+
+    }
+
+    /**
+     * @brief Destroy the pacer
+     */
+    cPacer::~cPacer()
+    {
+
+    }
+
+    /**
+     * @brief Set the ratio from a string
+     * @details Accepts a decimal number (1, 0.1) or a fraction (1/10)
+     * 
+     * @param[in] ratio     The ratio as string
+     * 
+     * @return true     The ratio is valid and set
+     * @return false    The ratio could not be parsed
+     */
+    bool cPacer::setRatio(std::string ratio)
+    {
+        double value = 0;
+
+        try
+        {
+            size_t slash = ratio.find('/');
+
+            if(slash != std::string::npos)
+            {
+                double divider = std::stod(ratio.substr(slash + 1));
+                value = divider > 0 ? std::stod(ratio.substr(0, slash)) / divider : 0;
+            }
+            else
+            {
+                value = std::stod(ratio);
+            }
+        }
+        catch(const std::exception& e)
+        {
+            return false;
+        }
+
+        if(value <= 0)
+        {
+            return false;
+        }
+
+        setRatio(value);
+        return true;
+    }
+
+    /**
+     * @brief Set the ratio
+     * 
+     * @param[in] ratio     Simulation seconds per wall clock second, 0 disables pacing
+     */
+    void cPacer::setRatio(double ratio)
+    {
+        _ratio = ratio;
+        _anchored = false;
+    }
+
+    /**
+     * @brief Restart the pacer
+     * @details Shall be called when the simulation was paused, the time spent
+     * in the pause must not be caught up.
+     */
+    void cPacer::restart()
+    {
+        _anchored = false;
+        _measuring = false;
+    }
+
+    /**
+     * @brief Pace the simulation
+     * @details Waits until the wall clock time belonging to the current
+     * simulation time. Shall be called regularly from the verilator thread, 
+     * e.g. after each quantum of ticks.
+     * 
+     * A single call waits at most cMaxWait and the wait ends early when the 
+     * run control has a pending command. At slow ratios the target can be
+     * minutes away, so the caller shall call pace() again with the same time
+     * until it returns true, and handle the run control in between.
+     * 
+     * @param[in] now   The current simulation time
+     * 
+     * @return true     The wall clock reached the simulation time
+     * @return false    The wait was capped or ended by the run control
+     */
+    bool cPacer::pace(simtime_t now)
+    {
+        if(_ratio <= 0)
+        {
+            return true;
+        }
+
+        tClock::time_point wall = tClock::now();
+        double simMs = now.ms();
+
+        if(!_anchored)
+        {
+            _anchorWall = wall;
+            _anchorSimMs = simMs;
+            _anchored = true;
+            return true;
+        }
+
+        std::chrono::duration<double, std::milli> wallElapsed((simMs - _anchorSimMs) / _ratio);
+        tClock::time_point target = _anchorWall + std::chrono::duration_cast<tClock::duration>(wallElapsed);
+
+        if(target - wall >= cMinSleep)
+        {
+            tClock::time_point deadline = std::min(target, wall + cMaxWait);
+
+            if(_runControl)
+            {
+                if(!_runControl->waitUntil(deadline))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                std::this_thread::sleep_until(deadline);
+            }
+
+            return deadline == target;
+        }
+        else if(wall - target > cMaxLag)
+        {
+            // Can't keep up, continue from here instead of catching up
+            _anchorWall = wall;
+            _anchorSimMs = simMs;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Measure the achieved ratio
+     * @details The ratio is measured over intervals of one second.
+     * 
+     * @param[in] now   The current simulation time
+     * 
+     * @return true     A new measurement is available, see getAchievedRatio()
+     */
+    bool cPacer::measure(simtime_t now)
+    {
+        tClock::time_point wall = tClock::now();
+        double simMs = now.ms();
+
+        if(!_measuring)
+        {
+            _measureWall = wall;
+            _measureSimMs = simMs;
+            _measuring = true;
+            return false;
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = wall - _measureWall;
+
+        if(elapsed < cMeasureInterval)
+        {
+            return false;
+        }
+
+        _achieved = (simMs - _measureSimMs) / elapsed.count();
+        _measureWall = wall;
+        _measureSimMs = simMs;
+
+        return true;
+    }
+
+}}
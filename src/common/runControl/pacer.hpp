@@ -0,0 +1,133 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Wall clock pacer header file                                 //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef PACER_HPP
+#define PACER_HPP
+
+#include <chrono>
+#include <string>
+
+#include "testbench.hpp"
+#include "runControl.hpp"
+
+namespace RoaLogic {
+    using namespace testbench;
+    using namespace testbench::clock;
+namespace control {
+
+    /**
+     * @class cPacer
+     * @brief Locks the simulation time to the wall clock
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details The pacer compares the simulation time with the steady clock. 
+     * With a ratio of 1.0 one second of simulation time takes one second of wall
+     * clock time, a ratio of 0.1 runs at 1/10 of real time. When the simulation
+     * is ahead, the verilator thread sleeps instead of spinning.
+     * 
+     * The pacer is anchored at a simulation and wall clock time. The target wall
+     * clock time is always calculated from this anchor, so errors of individual 
+     * sleeps don't accumulate. When the simulation can't keep up and falls behind
+     * more than cMaxLag, the pacer re-anchors instead of trying to catch up, which
+     * would result in a burst of frames. After a pause restart() shall be called.
+     * 
+     * The wait is done on the run control, so that a command ends it immediately,
+     * and a single wait is capped at cMaxWait. This keeps the testbench responsive
+     * at slow ratios, where the next target can be minutes away.
+     * 
+     * Independent of the pacing, the achieved ratio is measured every second.
+     */
+    class cPacer
+    {
+        private:
+        typedef std::chrono::steady_clock tClock;
+
+        static constexpr std::chrono::milliseconds cMaxLag{100};       //!< Re-anchor when behind this much
+        static constexpr std::chrono::milliseconds cMinSleep{1};       //!< Don't sleep for less than this
+        static constexpr std::chrono::milliseconds cMaxWait{100};      //!< Longest single wait of pace()
+        static constexpr std::chrono::seconds      cMeasureInterval{1}; //!< Interval of the achieved ratio measurement
+
+        cRunControl*       _runControl;         //!< Run control which ends a wait early, may be nullptr
+        double             _ratio = 0;          //!< Simulation seconds per wall clock second, 0 is not paced
+        bool               _anchored = false;   //!< The anchor is valid
+        tClock::time_point _anchorWall;         //!< Wall clock time of the anchor
+        double             _anchorSimMs = 0;    //!< Simulation time of the anchor in ms
+
+        tClock::time_point _measureWall;        //!< Wall clock start of the measurement interval
+        double             _measureSimMs = 0;   //!< Simulation time at the start of the measurement interval
+        bool               _measuring = false;  //!< The measurement interval is started
+        double             _achieved = 0;       //!< Last measured ratio
+
+        public:
+        cPacer(cRunControl* runControl = nullptr);
+        ~cPacer(void);
+
+        bool setRatio(std::string ratio);
+        void setRatio(double ratio);
+
+        /**
+         * @brief Check if pacing is enabled
+         */
+        bool isEnabled() const { return _ratio > 0; }
+
+        /**
+         * @brief Get the requested ratio
+         */
+        double getRatio() const { return _ratio; }
+
+        /**
+         * @brief Get the last measured ratio
+         */
+        double getAchievedRatio() const { return _achieved; }
+
+        void restart();
+        bool pace(simtime_t now);
+        bool measure(simtime_t now);
+    };
+
+}}
+
+#endif // PACER_HPP
@@ -0,0 +1,504 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Simulation run control implementation                        //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "runControl.hpp"
+
+namespace RoaLogic {
+namespace control {
+
+    /**
+     * @brief Construct a new run control object
+     * @details The simulation starts in the idle state, it is
+     * not running until a start or step command is given.
+     */
+    cRunControl::cRunControl()
+    {
+
+    }
+
+    /**
+     * @brief Destroy the run control object
+     * @details Makes sure that a waiting thread is released
+     */
+    cRunControl::~cRunControl()
+    {
+        terminate();
+    }
+
+    /**
+     * @brief Execute a command
+     * @details Every command replaces the current run limit and sets a new 
+     * state. This is done under the lock, so that the verilator thread can't 
+     * miss the wake-up between checking the state and waiting on the condition.
+     * 
+     * @param[in] state     The new run state
+     * @param[in] limit     The new run limit, an empty limit runs freely
+     */
+    void cRunControl::command(eSystemState state, sRunLimit limit)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _pendingLimit = limit;
+            _limitPending.store(true, std::memory_order_release);
+            _state = state;
+        }
+        _condition.notify_all();
+    }
+
+    /**
+     * @brief Start or resume the simulation without a limit
+     */
+    void cRunControl::start()
+    {
+        command(eSystemState::running, sRunLimit{});
+    }
+
+    /**
+     * @brief Pause the simulation
+     * @details Any active step or run until command is cancelled
+     */
+    void cRunControl::pause()
+    {
+        command(eSystemState::paused, sRunLimit{});
+    }
+
+    /**
+     * @brief Toggle between running and paused
+     * @details This is the behaviour of the play/pause button. Like command(),
+     * but the state is checked under the same lock as the transition. Otherwise
+     * a limit reached by the verilator thread or another command between the 
+     * check and the transition would be overwritten with a stale decision.
+     */
+    void cRunControl::toggle()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _pendingLimit = sRunLimit{};
+            _limitPending.store(true, std::memory_order_release);
+            _state = _state == eSystemState::running ? eSystemState::paused : eSystemState::running;
+        }
+        _condition.notify_all();
+    }
+
+    /**
+     * @brief Run a number of reference clock cycles and pause
+     * 
+     * @param[in] cycles    The number of cycles to run, 0 is ignored
+     */
+    void cRunControl::step(uint64_t cycles)
+    {
+        if(cycles != 0)
+        {
+            sRunLimit limit;
+            limit.cycleLimit = true;
+            limit.cycles = cycles;
+
+            command(eSystemState::running, limit);
+        }
+    }
+
+    /**
+     * @brief Run for a duration of simulation time and pause
+     * @details The duration starts at the moment the verilator 
+     * thread picks up the command.
+     * 
+     * @param[in] duration  The simulation time to run
+     */
+    void cRunControl::runFor(simtime_t duration)
+    {
+        sRunLimit limit;
+        limit.timeLimit = true;
+        limit.relative = true;
+        limit.time = duration;
+
+        command(eSystemState::running, limit);
+    }
+
+    /**
+     * @brief Run until a simulation time is reached and pause
+     * @details When the time already passed, the simulation
+     * pauses after the first tick.
+     * 
+     * @param[in] time      The simulation time to pause at
+     */
+    void cRunControl::runUntil(simtime_t time)
+    {
+        sRunLimit limit;
+        limit.timeLimit = true;
+        limit.time = time;
+
+        command(eSystemState::running, limit);
+    }
+
+    /**
+     * @brief Fast forward to a simulation time
+     * @details Starts the simulation without a limit, the target time
+     * is picked up by the testbench through takeFastForward().
+     * 
+     * @param[in] time      The simulation time to fast forward to
+     */
+    void cRunControl::fastForward(simtime_t time)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _fastForwardTime = time;
+            _fastForwardPending.store(true, std::memory_order_release);
+        }
+
+        command(eSystemState::running, sRunLimit{});
+    }
+
+    /**
+     * @brief Request a checkpoint action
+     * @details The action is executed by the testbench in the verilator
+     * thread, the run state doesn't change.
+     * 
+     * @param[in] action    Save or restore
+     * @param[in] fileName  The checkpoint file
+     */
+    void cRunControl::checkpoint(eCheckpointAction action, std::string fileName)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _checkpointAction = action;
+            _checkpointFile = fileName;
+            _checkpointPending.store(true, std::memory_order_release);
+        }
+        _condition.notify_all();
+    }
+
+    /**
+     * @brief Request a reset
+     * @details The reset is picked up by the verilator thread,
+     * also when the simulation is paused.
+     */
+    void cRunControl::reset()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _resetRequested = true;
+        }
+        _condition.notify_all();
+    }
+
+    /**
+     * @brief Request a restart
+     * @details Stops the simulation and cancels any run limit, the restart
+     * itself is picked up by the verilator thread. The simulation stays 
+     * idle until it is started again.
+     */
+    void cRunControl::restart()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _restartRequested = true;
+            _pendingLimit = sRunLimit{};
+            _limitPending.store(true, std::memory_order_release);
+            _state = eSystemState::idle;
+        }
+        _condition.notify_all();
+    }
+
+    /**
+     * @brief Terminate the simulation
+     * @details Releases the verilator thread when it is waiting,
+     * the caller is responsible for finishing the testbench.
+     */
+    void cRunControl::terminate()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _terminated = true;
+            _state = eSystemState::stopped;
+        }
+        _condition.notify_all();
+    }
+
+    /**
+     * @brief Handle a GUI event
+     * @details Translates the GUI events into run control commands.
+     * 
+     * - stateChange:   toggle between running and paused
+     * - reset:         request a reset
+     * - step:          data points to a uint64_t with the number of cycles, nullptr steps a single cycle
+     * - runFor:        data points to a simtime_t with the duration
+     * - runUntil:      data points to a simtime_t with the time to pause at
+     * - fastForward:   data points to a simtime_t with the time to fast forward to
+     * - saveCheckpoint:    data points to a std::string with the checkpoint file
+     * - restoreCheckpoint: data points to a std::string with the checkpoint file
+     * 
+     * @param[in] aEvent    The event which occured
+     * @param[in] data      The data of the event
+     * 
+     * @return true     The event is handled
+     * @return false    The event is not a run control event
+     */
+    bool cRunControl::handleEvent(eEvent aEvent, void* data)
+    {
+        bool result = true;
+
+        switch(aEvent)
+        {
+            case eEvent::stateChange:
+                toggle();
+                break;
+
+            case eEvent::reset:
+                reset();
+                break;
+
+            case eEvent::step:
+                step(data ? *reinterpret_cast<uint64_t*>(data) : 1);
+                break;
+
+            case eEvent::runFor:
+                if(data) runFor(*reinterpret_cast<simtime_t*>(data));
+                break;
+
+            case eEvent::runUntil:
+                if(data) runUntil(*reinterpret_cast<simtime_t*>(data));
+                break;
+
+            case eEvent::fastForward:
+                if(data) fastForward(*reinterpret_cast<simtime_t*>(data));
+                break;
+
+            case eEvent::saveCheckpoint:
+                if(data) checkpoint(eCheckpointAction::save, *reinterpret_cast<std::string*>(data));
+                break;
+
+            case eEvent::restoreCheckpoint:
+                if(data) checkpoint(eCheckpointAction::restore, *reinterpret_cast<std::string*>(data));
+                break;
+
+            default:
+                result = false;
+                break;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Check and clear a pending fast forward
+     * 
+     * @param[out] time     The simulation time to fast forward to
+     * 
+     * @return true when a fast forward was requested
+     */
+    bool cRunControl::takeFastForward(simtime_t& time)
+    {
+        if(!_fastForwardPending.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        time = _fastForwardTime;
+        _fastForwardPending.store(false, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /**
+     * @brief Check and clear a pending checkpoint action
+     * 
+     * @param[out] action   The requested action
+     * @param[out] fileName The checkpoint file
+     * 
+     * @return true when a checkpoint action was requested
+     */
+    bool cRunControl::takeCheckpoint(eCheckpointAction& action, std::string& fileName)
+    {
+        if(!_checkpointPending.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        action = _checkpointAction;
+        fileName = _checkpointFile;
+        _checkpointPending.store(false, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /**
+     * @brief Wait until the simulation may run
+     * @details Blocks the verilator thread until the state becomes running,
+     * a reset, restart or checkpoint action is requested or the simulation is terminated.
+     * The caller shall check these conditions again when this function returns.
+     * 
+     * @param[in] now   The current simulation time
+     */
+    void cRunControl::waitForRun(simtime_t now)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]{ return _state == eSystemState::running || 
+                                                 _resetRequested || 
+                                                 _restartRequested ||
+                                                 _checkpointPending ||
+                                                 _terminated; });
+        }
+
+        if(_limitPending.load(std::memory_order_acquire))
+        {
+            applyLimit(now);
+        }
+    }
+
+    /**
+     * @brief Check if a command waits to be picked up
+     * @details True when the simulation is not running anymore or when a reset,
+     * restart, checkpoint action, fast forward or new run limit is pending.
+     */
+    bool cRunControl::hasPendingCommand() const
+    {
+        return _state != eSystemState::running ||
+               _resetRequested ||
+               _restartRequested ||
+               _checkpointPending ||
+               _fastForwardPending ||
+               _limitPending ||
+               _terminated;
+    }
+
+    /**
+     * @brief Wait until a wall clock time while running
+     * @details Blocks the verilator thread until the deadline, unless a command 
+     * is pending or arrives in the meantime, see hasPendingCommand(). This is
+     * used instead of a plain sleep, so that a long wait doesn't delay a pause,
+     * step or close.
+     * 
+     * @param[in] deadline  The wall clock time to wait for
+     * 
+     * @return true     The deadline is reached
+     * @return false    The wait ended early because of a command
+     */
+    bool cRunControl::waitUntil(std::chrono::steady_clock::time_point deadline)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return !_condition.wait_until(lock, deadline, [this]{ return hasPendingCommand(); });
+    }
+
+    /**
+     * @brief Apply a pending run limit
+     * @details Copies the pending limit into the active limit, a relative
+     * time is converted into an absolute time at this point.
+     * 
+     * @param[in] now   The current simulation time
+     */
+    void cRunControl::applyLimit(simtime_t now)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _activeLimit = _pendingLimit;
+        _limitPending.store(false, std::memory_order_relaxed);
+
+        if(_activeLimit.relative)
+        {
+            _activeLimit.time = now + _activeLimit.time;
+            _activeLimit.relative = false;
+        }
+
+        _limitActive = _activeLimit.cycleLimit || _activeLimit.timeLimit;
+    }
+
+    /**
+     * @brief The active run limit is reached
+     * @details Pause the simulation, unless a new command arrived in the
+     * meantime. That command then determines what happens next.
+     */
+    void cRunControl::limitReached()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _limitActive = false;
+
+        if(!_limitPending.load(std::memory_order_relaxed) && _state == eSystemState::running)
+        {
+            _state = eSystemState::paused;
+        }
+    }
+
+    /**
+     * @brief Update the run limit
+     * @details This function shall be called after a tick when hasLimit() 
+     * returns true. It picks up new limits and pauses the simulation when 
+     * the active limit is reached.
+     * 
+     * @param[in] now               The current simulation time
+     * @param[in] cycleCompleted    A rising edge of the reference clock occured
+     */
+    void cRunControl::update(simtime_t now, bool cycleCompleted)
+    {
+        bool reached = false;
+
+        if(_limitPending.load(std::memory_order_acquire))
+        {
+            applyLimit(now);
+        }
+
+        if(_limitActive)
+        {
+            if(_activeLimit.cycleLimit && cycleCompleted)
+            {
+                reached = --_activeLimit.cycles == 0;
+            }
+
+            if(_activeLimit.timeLimit && now >= _activeLimit.time)
+            {
+                reached = true;
+            }
+
+            if(reached)
+            {
+                limitReached();
+            }
+        }
+    }
+
+}}
@@ -0,0 +1,223 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Simulation run control header file                           //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RUN_CONTROL_HPP
+#define RUN_CONTROL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <string>
+
+#include "testbench.hpp"
+#include "eventDefinition.hpp"
+
+namespace RoaLogic {
+    using namespace testbench;
+    using namespace testbench::clock;
+namespace control {
+
+    /**
+     * @class cRunControl
+     * @brief Simulation run control
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details This class controls when the verilated design is allowed to run.
+     * 
+     * The commands (start, pause, step, run for, run until, reset and terminate)
+     * are issued from the GUI thread, normally through the notify() function of 
+     * the testbench. The verilator thread polls the state once per loop and blocks 
+     * on a condition variable when the simulation is not running. Because of this
+     * a paused board does not use any processing power, while a resume only costs
+     * the wake-up of the verilator thread.
+     * 
+     * A step is counted in cycles of a reference clock, which is chosen by the 
+     * testbench. While a run limit is active (see hasLimit()) the testbench shall 
+     * call update() after every tick, with the current simulation time and whether
+     * a rising edge of the reference clock occured. When the requested number of 
+     * cycles or the requested time is reached the state falls back to paused.
+     * 
+     * A fast forward starts the simulation and passes a target time to the
+     * testbench, see takeFastForward(). It is up to the testbench to suspend
+     * everything that isn't needed until the target time is reached.
+     * 
+     * A restart stops the simulation and asks the testbench to bring the 
+     * design back to its initial state, see takeRestart(). 
+     * 
+     * Saving and restoring a checkpoint is done by the testbench in the 
+     * verilator thread, see takeCheckpoint(). Like a reset, a checkpoint 
+     * request is also picked up when the simulation is paused.
+     * 
+     * @attention The command functions can be called from any thread, the wait
+     * and accounting functions shall only be called from the verilator thread.
+     */
+    class cRunControl
+    {
+        public:
+        /**
+         * @brief Checkpoint actions
+         */
+        enum class eCheckpointAction
+        {
+            save,       //!< Save the board into a checkpoint file
+            restore     //!< Restore the board from a checkpoint file
+        };
+
+        private:
+        /**
+         * @brief Structure to hold a run limit
+         * @details A run limit pauses the simulation after a number
+         * of reference clock cycles or at a given simulation time.
+         */
+        struct sRunLimit
+        {
+            bool      cycleLimit = false;   //!< Pause after a number of cycles
+            uint64_t  cycles = 0;           //!< Number of reference clock cycles
+            bool      timeLimit = false;    //!< Pause at a simulation time
+            bool      relative = false;     //!< The time is relative to the moment the limit is applied
+            simtime_t time;                 //!< Simulation time (or duration) to pause at
+        };
+
+        std::atomic<eSystemState> _state = eSystemState::idle;   //!< Current run state
+        std::atomic<bool>         _resetRequested = false;       //!< A reset is requested
+        std::atomic<bool>         _restartRequested = false;     //!< A restart is requested
+        std::atomic<bool>         _terminated = false;           //!< Simulation is ending
+        std::atomic<bool>         _limitPending = false;         //!< A new run limit is waiting to be applied
+        std::atomic<bool>         _fastForwardPending = false;   //!< A fast forward is waiting to be picked up
+        std::atomic<bool>         _checkpointPending = false;    //!< A checkpoint action is waiting to be picked up
+
+        sRunLimit _pendingLimit;            //!< Run limit set by a command, protected by _mutex
+        sRunLimit _activeLimit;             //!< Run limit in use, only used in the verilator thread
+        bool      _limitActive = false;     //!< _activeLimit is in use, only used in the verilator thread
+        simtime_t _fastForwardTime;         //!< Target time of the fast forward, protected by _mutex
+        eCheckpointAction _checkpointAction = eCheckpointAction::save;  //!< Requested checkpoint action, protected by _mutex
+        std::string _checkpointFile;        //!< Checkpoint file, protected by _mutex
+
+        std::mutex              _mutex;     //!< Protects the state changes and the pending limit
+        std::condition_variable _condition; //!< Wakes the verilator thread
+
+        void command(eSystemState state, sRunLimit limit);
+        void applyLimit(simtime_t now);
+        void limitReached();
+
+        public:
+        cRunControl(void);
+        ~cRunControl(void);
+
+        void start();
+        void pause();
+        void toggle();
+        void step(uint64_t cycles);
+        void runFor(simtime_t duration);
+        void runUntil(simtime_t time);
+        void fastForward(simtime_t time);
+        void checkpoint(eCheckpointAction action, std::string fileName);
+        void reset();
+        void restart();
+        void terminate();
+
+        bool handleEvent(eEvent aEvent, void* data);
+
+        /**
+         * @brief Check if the design may run
+         * @details Lock free check which is done once per loop in the verilator thread
+         * 
+         * @return true when the design is running
+         */
+        bool isRunning() const { return _state.load(std::memory_order_relaxed) == eSystemState::running; }
+
+        /**
+         * @brief Check if a run limit must be tracked
+         * @details When this returns false, update() doesn't have to be called.
+         * @note Shall only be called from the verilator thread
+         */
+        bool hasLimit() const { return _limitActive || _limitPending.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Check and clear a pending reset request
+         * 
+         * @return true when a reset was requested
+         */
+        bool takeReset()
+        {
+            return _resetRequested.load(std::memory_order_relaxed) && 
+                   _resetRequested.exchange(false, std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Check and clear a pending restart request
+         * 
+         * @return true when a restart was requested
+         */
+        bool takeRestart()
+        {
+            return _restartRequested.load(std::memory_order_relaxed) && 
+                   _restartRequested.exchange(false, std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Check if the simulation is terminated
+         */
+        bool isTerminated() const { return _terminated.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get the current run state
+         */
+        eSystemState getState() const { return _state.load(); }
+
+        bool takeFastForward(simtime_t& time);
+        bool takeCheckpoint(eCheckpointAction& action, std::string& fileName);
+        void waitForRun(simtime_t now);
+        bool hasPendingCommand() const;
+        bool waitUntil(std::chrono::steady_clock::time_point deadline);
+        void update(simtime_t now, bool cycleCompleted);
+    };
+
+}}
+
+#endif // RUN_CONTROL_HPP
@@ -0,0 +1,158 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Tick quantum implementation                                  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "tickQuantum.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+
+namespace RoaLogic {
+namespace control {
+
+    /**
+     * @brief Construct a new tick quantum
+     * @details By default the quantum is adaptive with a target latency of 1ms
+     */
+    cTickQuantum::cTickQuantum()
+    {
+
+    }
+
+    /**
+     * @brief Destroy the tick quantum
+     */
+    cTickQuantum::~cTickQuantum()
+    {
+
+    }
+
+    /**
+     * @brief Set a fixed number of ticks per quantum
+     * @details A value of 0 restores the adaptive quantum. A value of 1
+     * checks the run control on every tick, as the original run loop did.
+     * 
+     * @param[in] ticks     The number of ticks per quantum
+     */
+    void cTickQuantum::setTicks(uint32_t ticks)
+    {
+        _adaptive = ticks == 0;
+        _ticks = _adaptive ? cDefaultTicks : ticks;
+    }
+
+    /**
+     * @brief Limit the quantum in simulation time
+     * @details The quantum ends when either the number of ticks or
+     * the simulation time is reached.
+     * 
+     * @param[in] time      The maximum simulation time of a quantum
+     */
+    void cTickQuantum::setTime(simtime_t time)
+    {
+        _time = time;
+        _timeBased = true;
+    }
+
+    /**
+     * @brief Set the target latency of the adaptive quantum
+     * 
+     * @param[in] latency   The target wall clock time of a quantum
+     */
+    void cTickQuantum::setTargetLatency(std::chrono::microseconds latency)
+    {
+        _targetLatency = latency;
+    }
+
+    /**
+     * @brief Mark the end of a quantum
+     * @details Updates the statistics and adapts the number of ticks. The
+     * number of ticks is only increased when the full quantum was executed,
+     * a quantum that ended early (time limit or pause) says nothing about 
+     * the speed of the design.
+     * 
+     * @param[in] ticks     The number of ticks executed in this quantum
+     */
+    void cTickQuantum::end(uint32_t ticks)
+    {
+        std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - _start;
+
+        _runTime += elapsed;
+        _totalTicks += ticks;
+        _numQuanta++;
+
+        if(_adaptive)
+        {
+            if(elapsed > _targetLatency)
+            {
+                _ticks = std::max(_ticks / 2, cMinTicks);
+            }
+            else if(ticks == _ticks && elapsed < _targetLatency / 2)
+            {
+                _ticks = std::min(_ticks * 2, cMaxTicks);
+            }
+        }
+    }
+
+    /**
+     * @brief Report the run statistics
+     * @details Logs the number of ticks per second and the ratio between
+     * simulation time and wall clock time. Running the same design with a
+     * quantum of 1 tick gives the numbers of the unbatched loop.
+     * 
+     * @param[in] simulated     The total simulated time
+     */
+    void cTickQuantum::report(simtime_t simulated) const
+    {
+        double seconds = std::chrono::duration<double>(_runTime).count();
+
+        if(seconds > 0 && _numQuanta > 0)
+        {
+            INFO << "Run statistics: " << _totalTicks << " ticks in " << seconds << "s, " 
+                 << static_cast<uint64_t>(_totalTicks / seconds) << " ticks/s, "
+                 << _totalTicks / _numQuanta << " ticks per quantum, " 
+                 << simulated.ms() / (seconds * 1000.0) << " simulated s per second\n";
+        }
+    }
+
+}}
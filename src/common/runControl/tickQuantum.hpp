@@ -0,0 +1,130 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Tick quantum header file                                     //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef TICK_QUANTUM_HPP
+#define TICK_QUANTUM_HPP
+
+#include <chrono>
+#include <cstdint>
+
+#include "testbench.hpp"
+
+namespace RoaLogic {
+    using namespace testbench;
+    using namespace testbench::clock;
+namespace control {
+
+    /**
+     * @class cTickQuantum
+     * @brief Batches testbench ticks between run control checks
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details Checking the run control on every clock edge costs atomic loads 
+     * and branches for each tick. Instead the testbench runs a quantum of ticks
+     * and only then checks the run control again.
+     * 
+     * The quantum is expressed in a number of ticks and optionally limited by an 
+     * amount of simulation time, whichever comes first. When adaptive, the number
+     * of ticks is doubled or halved after each quantum so that the wall clock time 
+     * of a quantum stays below the target latency. This latency is the worst case 
+     * delay between a GUI command and the reaction of the verilator thread.
+     * 
+     * The class also keeps track of the number of ticks and the wall clock time
+     * spent running, which is reported at the end of the simulation.
+     */
+    class cTickQuantum
+    {
+        private:
+        static constexpr uint32_t cMinTicks = 1;        //!< Smallest adaptive quantum
+        static constexpr uint32_t cMaxTicks = 1 << 24;  //!< Largest adaptive quantum
+        static constexpr uint32_t cDefaultTicks = 1024; //!< Start value of the adaptive quantum
+
+        uint32_t  _ticks = cDefaultTicks;               //!< Current quantum in ticks
+        bool      _adaptive = true;                     //!< Adapt the number of ticks to the target latency
+        bool      _timeBased = false;                   //!< The quantum is also limited in simulation time
+        simtime_t _time;                                //!< Maximum simulation time of a quantum
+        std::chrono::microseconds _targetLatency{1000}; //!< Target wall clock time of a quantum
+
+        std::chrono::steady_clock::time_point _start;   //!< Start of the current quantum
+        std::chrono::steady_clock::duration   _runTime{0};  //!< Total wall clock time spent running
+        uint64_t  _totalTicks = 0;                      //!< Total number of ticks
+        uint64_t  _numQuanta = 0;                       //!< Total number of quanta
+
+        public:
+        cTickQuantum(void);
+        ~cTickQuantum(void);
+
+        void setTicks(uint32_t ticks);
+        void setTime(simtime_t time);
+        void setTargetLatency(std::chrono::microseconds latency);
+
+        /**
+         * @brief Get the number of ticks in the next quantum
+         */
+        uint32_t getTicks() const { return _ticks; }
+
+        /**
+         * @brief Check if the quantum is limited in simulation time
+         */
+        bool isTimeBased() const { return _timeBased; }
+
+        /**
+         * @brief Get the maximum simulation time of a quantum
+         */
+        simtime_t getTime() const { return _time; }
+
+        /**
+         * @brief Mark the start of a quantum
+         */
+        void begin() { _start = std::chrono::steady_clock::now(); }
+
+        void end(uint32_t ticks);
+        void report(simtime_t simulated) const;
+    };
+
+}}
+
+#endif // TICK_QUANTUM_HPP
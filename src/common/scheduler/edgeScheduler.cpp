@@ -0,0 +1,446 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Clock edge scheduler implementation                          //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "edgeScheduler.hpp"
+
+#include <cmath>
+
+using namespace RoaLogic::testbench::clock::units;
+
+namespace RoaLogic {
+namespace scheduler {
+
+    /**
+     * @brief Convert a period in seconds to picoseconds
+     * @details A period is at least 1ps, otherwise the scheduler would not advance
+     */
+    uint64_t cEdgeClock::toPs(long double seconds)
+    {
+        long long ps = std::llround(seconds * 1.0e12L);
+
+        return ps < 1 ? 1 : static_cast<uint64_t>(ps);
+    }
+
+    /**
+     * @brief Construct a new clock
+     * @details The clock starts low, the first edge is a rising edge
+     * after the low period.
+     * 
+     * @param[in] scheduler     The scheduler which drives this clock
+     * @param[in] signal        The clock input of the design
+     * @param[in] lowPeriod     Low period in seconds
+     * @param[in] highPeriod    High period in seconds
+     */
+    cEdgeClock::cEdgeClock(cEdgeScheduler* scheduler, uint8_t& signal, long double lowPeriod, long double highPeriod) :
+        _scheduler(scheduler),
+        _signal(signal),
+        _lowPeriod(toPs(lowPeriod)),
+        _highPeriod(toPs(highPeriod))
+    {
+        _signal = 0;
+    }
+
+    /**
+     * @brief Set the low period
+     * @param[in] period    Low period in seconds
+     */
+    void cEdgeClock::setLowPeriod(long double period)
+    {
+        _lowPeriod = toPs(period);
+    }
+
+    /**
+     * @brief Set the high period
+     * @param[in] period    High period in seconds
+     */
+    void cEdgeClock::setHighPeriod(long double period)
+    {
+        _highPeriod = toPs(period);
+    }
+
+    /**
+     * @brief Enable the clock
+     * @details The next edge is scheduled one (half) period from now
+     */
+    void cEdgeClock::enable()
+    {
+        if(!_enabled)
+        {
+            _enabled = true;
+            _nextEdge = _scheduler->_now + (_signal ? _highPeriod : _lowPeriod);
+            _scheduler->schedule(this);
+        }
+    }
+
+    /**
+     * @brief Disable the clock
+     * @details The queued edge is invalidated and dropped when it reaches the
+     * top of the queue. The clock keeps its current level.
+     */
+    void cEdgeClock::disable()
+    {
+        if(_enabled)
+        {
+            _enabled = false;
+            _generation++;
+        }
+    }
+
+
+    /**
+     * @brief Construct a new edge scheduler
+     */
+    cEdgeScheduler::cEdgeScheduler()
+    {
+
+    }
+
+    /**
+     * @brief Destroy the edge scheduler and all its clocks
+     */
+    cEdgeScheduler::~cEdgeScheduler()
+    {
+        for(cEdgeClock* clock : _clocks)
+        {
+            delete clock;
+        }
+    }
+
+    /**
+     * @brief Add a clock with a 50% duty cycle
+     * 
+     * @param[in] signal    The clock input of the design
+     * @param[in] period    The clock period in seconds
+     * @param[in] enabled   Start the clock immediately
+     * 
+     * @return Pointer to the new clock, owned by the scheduler
+     */
+    cEdgeClock* cEdgeScheduler::addClock(uint8_t& signal, long double period, bool enabled)
+    {
+        return addClock(signal, period / 2.0L, period / 2.0L, enabled);
+    }
+
+    /**
+     * @brief Add a clock
+     * 
+     * @param[in] signal        The clock input of the design
+     * @param[in] lowPeriod     Low period in seconds
+     * @param[in] highPeriod    High period in seconds
+     * @param[in] enabled       Start the clock immediately
+     * 
+     * @return Pointer to the new clock, owned by the scheduler
+     */
+    cEdgeClock* cEdgeScheduler::addClock(uint8_t& signal, long double lowPeriod, long double highPeriod, bool enabled)
+    {
+        cEdgeClock* clock = new cEdgeClock(this, signal, lowPeriod, highPeriod);
+        _clocks.push_back(clock);
+
+        if(enabled)
+        {
+            clock->enable();
+        }
+
+        return clock;
+    }
+
+    /**
+     * @brief Queue the next edge of a clock
+     */
+    void cEdgeScheduler::schedule(cEdgeClock* clock)
+    {
+        _queue.push(sEdge{clock->_nextEdge, clock, clock->_generation});
+    }
+
+    /**
+     * @brief Queue a coroutine waiting for a time
+     */
+    void cEdgeScheduler::addTimer(uint64_t time, std::coroutine_handle<> handle)
+    {
+        _timers.push(sTimer{time, _timerSequence++, handle});
+    }
+
+    /**
+     * @brief Wait for a simulation time delay
+     * @details Use as co_await scheduler.delay(100.0_ns), the coroutine
+     * is resumed after the design is evaluated at that time.
+     * 
+     * @param[in] time  The delay in seconds
+     * 
+     * @return The awaiter
+     */
+    cEdgeScheduler::sDelayAwaiter cEdgeScheduler::delay(long double time)
+    {
+        long long ps = std::llround(time * 1.0e12L);
+
+        return sDelayAwaiter{*this, _now + (ps < 0 ? 0 : static_cast<uint64_t>(ps))};
+    }
+
+    /**
+     * @brief Advance to the next edge time
+     * @details Jumps to the earliest scheduled edge or wake-up time. Every 
+     * clock with an edge at that time is toggled and its next edge is queued,
+     * the coroutines waiting for that time are collected for resumeWaiters().
+     * Entries of disabled clocks are dropped on the way.
+     * 
+     * @return The number of clocks that toggled plus the number of timers 
+     * that expired, 0 when there is nothing left to schedule
+     */
+    size_t cEdgeScheduler::advance()
+    {
+        uint64_t next = UINT64_MAX;
+
+        _toggled.clear();
+
+        // Drop stale entries of disabled clocks
+        while(!_queue.empty() && _queue.top().generation != _queue.top().clock->_generation)
+        {
+            _queue.pop();
+        }
+
+        if(!_queue.empty())
+        {
+            next = _queue.top().time;
+        }
+
+        if(!_timers.empty() && _timers.top().time < next)
+        {
+            next = _timers.top().time;
+        }
+
+        if(next == UINT64_MAX)
+        {
+            return 0;
+        }
+
+        // Timers from before a restore never move the time backwards
+        if(next > _now)
+        {
+            _now = next;
+        }
+
+        // Toggle all clocks with an edge at this time
+        while(!_queue.empty())
+        {
+            const sEdge edge = _queue.top();
+
+            if(edge.generation != edge.clock->_generation)
+            {
+                _queue.pop();
+                continue;
+            }
+
+            if(edge.time > _now)
+            {
+                break;
+            }
+
+            _queue.pop();
+
+            cEdgeClock* clock = edge.clock;
+            clock->_signal = !clock->_signal;
+            clock->_nextEdge = _now + (clock->_signal ? clock->_highPeriod : clock->_lowPeriod);
+            schedule(clock);
+
+            _toggled.push_back(clock);
+        }
+
+        // Collect the expired timers
+        while(!_timers.empty() && _timers.top().time <= _now)
+        {
+            _dueTimers.push_back(_timers.top().handle);
+            _timers.pop();
+        }
+
+        return _toggled.size() + _dueTimers.size();
+    }
+
+    /**
+     * @brief Resume the coroutines waiting for the last step
+     * @details Shall be called after the design is evaluated. First the
+     * coroutines waiting for an edge are resumed, followed by the coroutines
+     * waiting for the time. The waiter lists are swapped out first, so that 
+     * a resumed coroutine can wait for the next edge of the same clock.
+     */
+    void cEdgeScheduler::resumeWaiters()
+    {
+        std::vector<std::coroutine_handle<>> waiters;
+
+        for(cEdgeClock* clock : _toggled)
+        {
+            std::vector<std::coroutine_handle<>>& list = clock->_signal ? clock->_posEdgeWaiters 
+                                                                        : clock->_negEdgeWaiters;
+            if(!list.empty())
+            {
+                waiters.swap(list);
+
+                for(std::coroutine_handle<> handle : waiters)
+                {
+                    handle.resume();
+                }
+
+                waiters.clear();
+            }
+        }
+
+        if(!_dueTimers.empty())
+        {
+            waiters.swap(_dueTimers);
+
+            for(std::coroutine_handle<> handle : waiters)
+            {
+                handle.resume();
+            }
+        }
+    }
+
+    /**
+     * @brief Drop all waiting coroutines
+     * @details The coroutines are not resumed. Shall be called before the 
+     * waiting coroutines are destroyed, see cTaskPool::clear().
+     */
+    void cEdgeScheduler::clearWaiters()
+    {
+        for(cEdgeClock* clock : _clocks)
+        {
+            clock->_posEdgeWaiters.clear();
+            clock->_negEdgeWaiters.clear();
+        }
+
+        _timers = decltype(_timers)();
+        _dueTimers.clear();
+    }
+
+    /**
+     * @brief Save the scheduler state
+     * @details Saves the current time and the periods, next edge and
+     * enable state of every clock, in the order the clocks were added.
+     * 
+     * @param[in] os    The checkpoint stream
+     */
+    void cEdgeScheduler::save(VerilatedSerialize& os)
+    {
+        uint64_t numClocks = _clocks.size();
+
+        os << _now << numClocks;
+
+        for(cEdgeClock* clock : _clocks)
+        {
+            os << clock->_lowPeriod << clock->_highPeriod << clock->_nextEdge << clock->_enabled;
+        }
+    }
+
+    /**
+     * @brief Restore the scheduler state
+     * @details The queue is rebuilt from the restored clocks, entries
+     * scheduled before the restore are dropped.
+     * 
+     * @param[in] os    The checkpoint stream
+     * 
+     * @return false when the checkpoint holds a different number of clocks
+     */
+    bool cEdgeScheduler::restore(VerilatedDeserialize& os)
+    {
+        uint64_t now = 0;
+        uint64_t numClocks = 0;
+
+        os >> now >> numClocks;
+
+        if(numClocks != _clocks.size())
+        {
+            return false;
+        }
+
+        _now = now;
+        _queue = decltype(_queue)();
+        _toggled.clear();
+
+        for(cEdgeClock* clock : _clocks)
+        {
+            os >> clock->_lowPeriod >> clock->_highPeriod >> clock->_nextEdge >> clock->_enabled;
+            clock->_generation++;
+
+            if(clock->_enabled)
+            {
+                schedule(clock);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Get the current time
+     */
+    simtime_t cEdgeScheduler::getTime() const
+    {
+        return simtime_t(_now * 1.0_ps);
+    }
+
+    /**
+     * @brief Get the current time in the time precision of a verilated context
+     * 
+     * @param[in] context   The verilated context
+     * 
+     * @return The current time in units of the context time precision
+     */
+    uint64_t cEdgeScheduler::getContextTime(const VerilatedContext* context) const
+    {
+        int precision = context->timeprecision();   // e.g. -12 for ps
+        uint64_t time = _now;
+
+        for(int i = precision; i > -12; i--)
+        {
+            time /= 10;
+        }
+
+        for(int i = precision; i < -12; i++)
+        {
+            time *= 10;
+        }
+
+        return time;
+    }
+
+}}
@@ -0,0 +1,254 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Clock edge scheduler header file                             //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef EDGE_SCHEDULER_HPP
+#define EDGE_SCHEDULER_HPP
+
+#include <cstdint>
+#include <vector>
+#include <queue>
+#include <coroutine>
+
+#include "testbench.hpp"
+#include "verilated_save.h"
+
+namespace RoaLogic {
+    using namespace testbench;
+    using namespace testbench::clock;
+namespace scheduler {
+
+    class cEdgeScheduler;
+
+    /**
+     * @class cEdgeClock
+     * @brief Clock driven by the edge scheduler
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details A clock drives a single clock input of the verilated design. The 
+     * low and high period are set in seconds, the same way as the testbench 
+     * clocks, and are internally kept in picoseconds. This keeps the edge times 
+     * exact, so that edges of related clocks really coincide.
+     * 
+     * A disabled clock is not scheduled at all, it costs nothing until it
+     * is enabled again. Period changes take effect from the next edge on.
+     * 
+     * Coroutines can wait for an edge with co_await clock->posEdge() or
+     * co_await clock->negEdge(). They are resumed after the design is evaluated.
+     */
+    class cEdgeClock
+    {
+        friend class cEdgeScheduler;
+
+        private:
+        cEdgeScheduler* _scheduler;         //!< The scheduler this clock belongs to
+        uint8_t&        _signal;            //!< The clock input of the design
+        uint64_t        _lowPeriod;         //!< Low period in ps
+        uint64_t        _highPeriod;        //!< High period in ps
+        uint64_t        _nextEdge = 0;      //!< Time of the next edge in ps
+        uint64_t        _generation = 0;    //!< Invalidates queued edges when the clock is disabled
+        bool            _enabled = false;   //!< Clock is running
+
+        std::vector<std::coroutine_handle<>> _posEdgeWaiters;   //!< Coroutines waiting for a rising edge
+        std::vector<std::coroutine_handle<>> _negEdgeWaiters;   //!< Coroutines waiting for a falling edge
+
+        static uint64_t toPs(long double seconds);
+
+        public:
+        /**
+         * @brief Awaiter for a clock edge
+         */
+        struct sEdgeAwaiter
+        {
+            std::vector<std::coroutine_handle<>>& waiters;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { waiters.push_back(handle); }
+            void await_resume() const noexcept {}
+        };
+
+        cEdgeClock(cEdgeScheduler* scheduler, uint8_t& signal, long double lowPeriod, long double highPeriod);
+
+        void setLowPeriod(long double period);
+        void setHighPeriod(long double period);
+        void enable();
+        void disable();
+
+        bool isEnabled() const { return _enabled; }
+
+        sEdgeAwaiter posEdge() { return sEdgeAwaiter{_posEdgeWaiters}; }
+        sEdgeAwaiter negEdge() { return sEdgeAwaiter{_negEdgeWaiters}; }
+    };
+
+    /**
+     * @class cEdgeScheduler
+     * @brief Next-edge clock scheduler
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details The scheduler keeps the next edge of every enabled clock in a 
+     * priority queue. advance() jumps directly to the earliest edge time and 
+     * toggles all clocks which have an edge at that time, the testbench then 
+     * evaluates the design once for all these edges. 
+     * 
+     * The cost of a step only depends on the number of clocks that toggle,
+     * disabled clocks are not part of the queue.
+     * 
+     * Next to clock edges, coroutines can wait for a simulation time delay with
+     * co_await scheduler.delay(time). The wake-up times are kept in a second 
+     * priority queue, advance() also stops at these times. Waiting coroutines 
+     * are only touched when their edge or time is reached, so waiting tasks 
+     * don't add any cost to a step.
+     * 
+     * The time and the state of all clocks can be saved into a checkpoint, see
+     * save() and restore(). The level of a clock is part of the verilated model.
+     * Coroutines waiting for an edge or delay are not part of a checkpoint, they 
+     * keep waiting in the restored timeline.
+     * 
+     * Typical use in a testbench tick:
+     * @code {.c++}
+     * if(_scheduler.advance())
+     * {
+     *     _core->contextp()->time(_scheduler.getContextTime(_core->contextp()));
+     *     _core->eval();
+     *     _scheduler.resumeWaiters();
+     * }
+     * @endcode
+     */
+    class cEdgeScheduler
+    {
+        friend class cEdgeClock;
+
+        private:
+        /**
+         * @brief Queue entry, a scheduled edge of a clock
+         */
+        struct sEdge
+        {
+            uint64_t    time;           //!< Time of the edge in ps
+            cEdgeClock* clock;          //!< The clock
+            uint64_t    generation;     //!< Generation of the clock when scheduled
+
+            bool operator>(const sEdge& other) const { return time > other.time; }
+        };
+
+        /**
+         * @brief Timer entry, a coroutine waiting for a time
+         */
+        struct sTimer
+        {
+            uint64_t    time;           //!< Wake-up time in ps
+            uint64_t    sequence;       //!< Keeps timers with the same time in order
+            std::coroutine_handle<> handle; //!< The waiting coroutine
+
+            bool operator>(const sTimer& other) const 
+            {
+                return time > other.time || (time == other.time && sequence > other.sequence);
+            }
+        };
+
+        /**
+         * @brief Awaiter for a time delay
+         */
+        struct sDelayAwaiter
+        {
+            cEdgeScheduler& scheduler;
+            uint64_t        time;       //!< Wake-up time in ps
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.addTimer(time, handle); }
+            void await_resume() const noexcept {}
+        };
+
+        std::priority_queue<sEdge, std::vector<sEdge>, std::greater<sEdge>> _queue;  //!< Min-heap of next edges
+        std::vector<cEdgeClock*> _clocks;   //!< All clocks owned by the scheduler
+        std::vector<cEdgeClock*> _toggled;  //!< Clocks that toggled in the last step
+        uint64_t _now = 0;                  //!< Current time in ps
+
+        std::priority_queue<sTimer, std::vector<sTimer>, std::greater<sTimer>> _timers;  //!< Min-heap of wake-up times
+        std::vector<std::coroutine_handle<>> _dueTimers;    //!< Coroutines whose time is reached in the last step
+        uint64_t _timerSequence = 0;        //!< Sequence number of the next timer
+
+        void schedule(cEdgeClock* clock);
+        void addTimer(uint64_t time, std::coroutine_handle<> handle);
+
+        public:
+        cEdgeScheduler(void);
+        ~cEdgeScheduler(void);
+
+        cEdgeClock* addClock(uint8_t& signal, long double period, bool enabled = true);
+        cEdgeClock* addClock(uint8_t& signal, long double lowPeriod, long double highPeriod, bool enabled);
+
+        size_t advance();
+        void resumeWaiters();
+        void clearWaiters();
+
+        sDelayAwaiter delay(long double time);
+
+        void save(VerilatedSerialize& os);
+        bool restore(VerilatedDeserialize& os);
+
+        /**
+         * @brief Get the current time in ps
+         */
+        uint64_t getTimePs() const { return _now; }
+
+        /**
+         * @brief Get the number of clocks
+         */
+        size_t getNumClocks() const { return _clocks.size(); }
+
+        simtime_t getTime() const;
+        uint64_t getContextTime(const VerilatedContext* context) const;
+
+        /**
+         * @brief Get the clocks that toggled in the last step
+         */
+        const std::vector<cEdgeClock*>& getToggled() const { return _toggled; }
+    };
+
+}}
+
+#endif // EDGE_SCHEDULER_HPP
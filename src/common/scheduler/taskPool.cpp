@@ -0,0 +1,158 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Coroutine task pool                                          //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "taskPool.hpp"
+
+#include "log.hpp"
+
+#include <exception>
+
+namespace RoaLogic {
+namespace scheduler {
+
+    /**
+     * @brief Handle an exception thrown by a task
+     * @details A testbench can't continue in a defined state, so the
+     * exception ends the program.
+     */
+    void cTask::promise_type::unhandled_exception()
+    {
+        ERROR << "Unhandled exception in testbench task\n";
+        std::terminate();
+    }
+
+    /**
+     * @brief Destroy the task state
+     * @details Called when the task finishes or is destroyed by the pool,
+     * the task is removed from the pool.
+     */
+    cTask::promise_type::~promise_type()
+    {
+        if(pool)
+        {
+            pool->_tasks.erase(entry);
+        }
+    }
+
+    /**
+     * @brief Construct a new task pool
+     * 
+     * @param[in] scheduler     The scheduler the tasks wait on
+     */
+    cTaskPool::cTaskPool(cEdgeScheduler& scheduler) :
+        _scheduler(scheduler)
+    {
+
+    }
+
+    /**
+     * @brief Destroy the task pool and all remaining tasks
+     */
+    cTaskPool::~cTaskPool()
+    {
+        clear();
+    }
+
+    /**
+     * @brief Start a task
+     * @details The pool takes ownership of the task and runs it until 
+     * its first co_await. A task that finishes immediately is gone when 
+     * this function returns.
+     * 
+     * @param[in] task  The task to start
+     */
+    void cTaskPool::spawn(cTask&& task)
+    {
+        std::coroutine_handle<cTask::promise_type> handle = task._handle;
+
+        if(handle)
+        {
+            task._handle = nullptr;
+
+            handle.promise().pool = this;
+            handle.promise().entry = _tasks.insert(_tasks.end(), handle);
+
+            handle.resume();
+        }
+    }
+
+    /**
+     * @brief Destroy all remaining tasks
+     * @details All waiting coroutines are dropped from the scheduler first,
+     * the pool is expected to own all coroutines waiting on the scheduler.
+     */
+    void cTaskPool::clear()
+    {
+        _scheduler.clearWaiters();
+
+        while(!_tasks.empty())
+        {
+            // Destroying the task removes it from the list
+            _tasks.front().destroy();
+        }
+    }
+
+    /**
+     * @brief Resume all waiting tasks
+     * @details The waiter list is swapped out first, so that a resumed
+     * task can wait for the next fire().
+     * 
+     * @return The number of tasks that were resumed
+     */
+    size_t cTrigger::fire()
+    {
+        std::vector<std::coroutine_handle<>> waiters;
+
+        waiters.swap(_waiters);
+
+        for(std::coroutine_handle<> handle : waiters)
+        {
+            handle.resume();
+        }
+
+        return waiters.size();
+    }
+
+}}
@@ -0,0 +1,189 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Coroutine task pool header file                              //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef TASK_POOL_HPP
+#define TASK_POOL_HPP
+
+#include <coroutine>
+#include <list>
+#include <vector>
+#include <cstddef>
+
+#include "edgeScheduler.hpp"
+
+namespace RoaLogic {
+namespace scheduler {
+
+    class cTaskPool;
+
+    /**
+     * @class cTask
+     * @brief Testbench task coroutine
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details A task is a coroutine which runs in the verilator thread, for 
+     * example a stimulus generator or a checker. A function becomes a task by
+     * returning cTask, it can then wait for a clock edge, a time delay or a 
+     * trigger:
+     * 
+     * @code {.c++}
+     * cTask cMyBoard::pressKey()
+     * {
+     *     co_await _scheduler.delay(1.0_us);
+     *     bitClr8(key, 1);
+     *     co_await clk_50->posEdge();
+     *     bitSet8(key, 1);
+     * }
+     * @endcode
+     * 
+     * A task doesn't run until it is handed to a cTaskPool with spawn(). The
+     * pool owns the task from then on. A finished task is destroyed immediately,
+     * the remaining tasks are destroyed when the pool is cleared.
+     */
+    class cTask
+    {
+        public:
+        struct promise_type
+        {
+            cTaskPool* pool = nullptr;                          //!< Owner of the task, set by spawn()
+            std::list<std::coroutine_handle<>>::iterator entry; //!< Position in the task list of the pool
+
+            cTask get_return_object() { return cTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception();
+
+            ~promise_type();
+        };
+
+        private:
+        friend class cTaskPool;
+        std::coroutine_handle<promise_type> _handle;
+
+        explicit cTask(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+        public:
+        cTask(cTask&& other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+        cTask(const cTask&) = delete;
+        cTask& operator=(const cTask&) = delete;
+
+        /**
+         * @brief Destroy a task which was never spawned
+         */
+        ~cTask()
+        {
+            if(_handle) _handle.destroy();
+        }
+    };
+
+    /**
+     * @class cTaskPool
+     * @brief Pool of testbench tasks
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details The pool owns all tasks of a testbench. A spawned task runs
+     * immediately until its first co_await, after that it is only resumed by
+     * the edge scheduler or a trigger when the condition it waits for occurs. 
+     * Because of this a large number of waiting tasks don't cost anything 
+     * per tick, a task is only touched when it is resumed.
+     * 
+     * @attention Tasks run in the verilator thread, spawn() and clear() shall 
+     * only be called from the verilator thread.
+     */
+    class cTaskPool
+    {
+        friend struct cTask::promise_type;
+
+        private:
+        cEdgeScheduler& _scheduler;                     //!< Scheduler the tasks wait on
+        std::list<std::coroutine_handle<>> _tasks;      //!< All tasks which are not finished
+
+        public:
+        cTaskPool(cEdgeScheduler& scheduler);
+        ~cTaskPool();
+
+        void spawn(cTask&& task);
+        void clear();
+
+        /**
+         * @brief Get the number of tasks which are not finished
+         */
+        size_t size() const { return _tasks.size(); }
+    };
+
+    /**
+     * @class cTrigger
+     * @brief Awaitable event for tasks
+     * @version 0.1
+     * @date 16-oct-2026
+     *
+     * @details Tasks wait for a trigger with co_await trigger. All tasks
+     * waiting at that moment are resumed by fire(), a task that waits again
+     * waits for the next fire(). This is used for conditions that are not 
+     * related to the time, e.g. a reset request from the GUI.
+     * 
+     * @attention fire() shall be called from the verilator thread, outside
+     * of the evaluation of the design. A trigger is not cleared by the task 
+     * pool, so it shall not be fired after the pool is cleared.
+     */
+    class cTrigger
+    {
+        private:
+        std::vector<std::coroutine_handle<>> _waiters;  //!< Tasks waiting for the trigger
+
+        public:
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { _waiters.push_back(handle); }
+        void await_resume() const noexcept {}
+
+        size_t fire();
+    };
+
+}}
+
+#endif // TASK_POOL_HPP
@@ -52,19 +52,18 @@ using namespace RoaLogic::vdb;
  * @details This function gets called when the 7-Segment Display
  * state in the design changes.
  * 
- * It will pass it's event to the handleLedEvent so that it 
- * can be processed correctly within the virtual 7-Segment Display class.
+ * It will pass it's event to the 7-Segment Display with the same ID so 
+ * that it can be processed correctly within the virtual 7-Segment Display class.
  * 
  * @attention This function runs in the verilator thread context
  */
 void vdb7SegmentDisplayUpdate(int id, const svBitVecVal* val)
 {
     #ifdef DBG_VDB_7SEGMENT
-    INFO << "7-Segment display: Update event: " << svGetScope() << "\n";
+    INFO << "7-Segment display: Update event: " << id << "\n";
     #endif
-    // Get the scope of the current call and pass this into the processing function
-    // Pass the value of the 7-Segment Display alongside it
-    cVDBCommon::processVerilatorEvent(svGetScope(), *val);
+    // Pass the value of the 7-Segment Display to the display with this ID
+    cVdb7SegmentDisplay::dispatch<&cVdb7SegmentDisplay::update>(id, static_cast<uint32_t>(*val));
 }
 
 
@@ -77,18 +76,18 @@ namespace vdb
      * @brief Construct a new cVdb7SegmentDisplay object
      * @details This constructer creates a new cVdb7SegmentDisplay object
      *
-     * First the scope is set according to the given name, where it is
-     * also checked that the scope exists. When this is ok, it registers
-     * this class for any verilator actions.
+     * The events of the display are dispatched by ID, so it registers 
+     * this class by its ID. The verilated instance has no scope, the 
+     * scope name is only used for debugging.
      *
      * @param[in] scopeName     Scope of this 7-Segment Display
-     * @param[in] id            Optional ID of this led (mainly used for debugging)
+     * @param[in] id            ID of this display, must match the ID parameter of the instance
      */
     cVdb7SegmentDisplay::cVdb7SegmentDisplay(std::string scopeName, uint8_t id) :
-        cVDBCommon(scopeName, id)
+        cVDBComponent(scopeName, id, eDispatch::byID)
     {
         #ifdef DBG_VDB_7SEGMENT
-        INFO << "7-Segment: Create: ID " << id << " Scope: "<< svGetScope() << "\n";
+        INFO << "7-Segment: Create: ID " << id << " Scope: "<< scopeName << "\n";
         #endif
     }
 
@@ -103,20 +102,96 @@ namespace vdb
     }
 
     /**
-     * @brief Callback function for a verilated 7-Segment Display event
+     * @brief Handler for a verilated 7-Segment Display event
      * @details This function handles the 7-Segment Display update events coming
-     * from the verilated design. It checks if the event is alright and
-     * then notifies all classes which are registered to it.
+     * from the verilated design. The value is only stored, it is committed by 
+     * commit() at the end of the time step.
      *
-     * @param[in] event The new value of the 7-Segment Display
+     * @param[in] value The new value of the 7-Segment Display
      */
-    void cVdb7SegmentDisplay::verilatorCallback(uint32_t event)
+    void cVdb7SegmentDisplay::update(uint32_t value)
     {
         #ifdef DBG_VDB_7SEGMENT
-        INFO << "7Segment: Received ID " << _myID << " event: " << event << "\n";
+        INFO << "7Segment: Received ID " << _myID << " value: " << value << "\n";
         #endif
 
-        notifyObserver(eEvent::sevenSegmentUpdate, &event);
+        _pendingValue = value;
+        markPending();
+    }
+
+    /**
+     * @brief Sample the value of the 7-Segment Display
+     * @details Used when the DPI function is compiled out of the design, 
+     * see VDB_SAMPLED_OUTPUTS. The first value, and a value that differs from
+     * the previous one, is handled as an update.
+     * 
+     * @note Runs in the verilator thread context
+     *
+     * @param[in] value The sampled value of the 7-Segment Display
+     */
+    void cVdb7SegmentDisplay::sample(uint32_t value)
+    {
+        tCallbackLock callbackLock(_callbackMutex);
+
+        if(!_valid || value != _pendingValue)
+        {
+            update(value);
+        }
+    }
+
+    /**
+     * @brief Commit the last received value
+     * @details When the value differs from the last committed value all
+     * classes which are registered to it are notified. While the notifications
+     * are suspended only the value is stored.
+     * 
+     * @return true when the observers are notified
+     */
+    bool cVdb7SegmentDisplay::commit()
+    {
+        if(_valid && _pendingValue == _value)
+        {
+            return false;
+        }
+
+        _value = _pendingValue;
+        _valid = true;
+
+        if(notificationsSuspended())
+        {
+            return false;
+        }
+
+        notifyObserver(eEvent::sevenSegmentUpdate, &_value);
+        return true;
+    }
+
+    /**
+     * @brief Resync the observers with the last value of the display
+     */
+    void cVdb7SegmentDisplay::resync()
+    {
+        if(_valid)
+        {
+            notifyObserver(eEvent::sevenSegmentUpdate, &_value);
+        }
+    }
+
+    /**
+     * @brief Save the display state into a checkpoint
+     */
+    void cVdb7SegmentDisplay::saveState(VerilatedSerialize& os)
+    {
+        os << _value << _valid;
+    }
+
+    /**
+     * @brief Restore the display state from a checkpoint
+     */
+    void cVdb7SegmentDisplay::restoreState(VerilatedDeserialize& os)
+    {
+        os >> _value >> _valid;
+        _pendingValue = _value;
     }
 
 }
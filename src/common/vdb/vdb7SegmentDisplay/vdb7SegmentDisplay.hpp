@@ -52,7 +52,7 @@
 #ifndef VDB_7SEGMENT_HPP
 #define VDB_7SEGMENT_HPP
 
-#include "vdbCommon.hpp"
+#include "vdbComponent.hpp"
 
 namespace RoaLogic
 {
@@ -68,20 +68,41 @@ namespace vdb
      *
      * @details This class controls a verilated 7-Segment Display instance.
      *
-     * It takes the verilator event through the verilator callback and notifies
-     * anyone listening to this led. This class fully runs in the verilated context.
-     * The base is the cVDBCommon class which does all the low level handling and 
-     * setting up the callback mechanism for any DPI functions. The user shall call
-     * the cVDBCommon::processVerilatorEvent with the scope and the eventual event.
+     * It takes the verilator event through the update handler and notifies
+     * anyone listening to this display. This class fully runs in the verilated context.
+     * The base is the cVDBComponent class which does all the low level handling and 
+     * setting up the callback mechanism for any DPI functions. The DPI functions 
+     * dispatch the new value to the display with the ID of the instance.
+     * 
+     * The observers receive the sevenSegmentUpdate event, the payload is the
+     * value of the segments. The value is committed at the end of the time step
+     * or settling window, and only notified when it differs from the last one.
+     * 
+     * When the design is built with VDB_SAMPLED_OUTPUTS no DPI function is 
+     * called, the board samples the value from the model and passes it to
+     * sample() instead.
      */
-    class cVdb7SegmentDisplay : public cVDBCommon
+    class cVdb7SegmentDisplay : public cVDBComponent<cVdb7SegmentDisplay, uint32_t>
     {
+        friend void ::vdb7SegmentDisplayUpdate(int id, const svBitVecVal* val);
+
         private:
-        void verilatorCallback(uint32_t event);
+        uint32_t _value = 0;        //!< Last committed value of the display
+        bool     _valid = false;    //!< A value has been committed
+        uint32_t _pendingValue = 0; //!< Last received value of the display
+
+        void update(uint32_t value);
+        bool commit();
+        void resync();
 
         public:
         cVdb7SegmentDisplay(std::string scopeName, uint8_t id);
         ~cVdb7SegmentDisplay();
+
+        void saveState(VerilatedSerialize& os);
+        void restoreState(VerilatedDeserialize& os);
+
+        void sample(uint32_t value);
     };
 }
 }
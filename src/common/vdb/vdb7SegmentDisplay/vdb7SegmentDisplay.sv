@@ -86,11 +86,15 @@ module vdb7SegmentDisplay
   //-----------------------
   // DPI Functions
   //
-  import "DPI-C" context function void vdb7SegmentDisplayUpdate(int id, bit [7:0] val);
+  import "DPI-C" function void vdb7SegmentDisplayUpdate(int id, bit [7:0] val);
 
 
   //-----------------------
   // Module body
   //
+  // With VDB_SAMPLED_OUTPUTS the testbench samples the display value
+  // from the model, no DPI function is called.
+`ifndef VDB_SAMPLED_OUTPUTS
   always @(in) vdb7SegmentDisplayUpdate(ID, in);
+`endif
 endmodule
@@ -46,9 +46,6 @@
 #include "wxWidgetsVdb7SegmentDisplay.hpp"
 #include "wxGuiDistance.hpp"
 
-// Define the wxEVT_7SegmentDisplay, which is special within this class
-wxDEFINE_EVENT(wxEVT_7SegmentDisplay, wxCommandEvent);
-
 namespace RoaLogic {
     using namespace observer;
 namespace GUI {
@@ -56,18 +53,14 @@ namespace GUI {
     /**
      * @brief Construct a new wxWidgets 7-Segment Display window
      * @details 
-     * This is the constructor for the 7-Segment Display window
-     * Bind the onEvent function with the ID to a wxEVT_7SegmentDisplay event.
+     * This is the constructor for the 7-Segment Display window. The events
+     * of the display are received through the vdb event channel.
      * 
      */
     cWXVdb7SegmentDisplay::cWXVdb7SegmentDisplay(cVDBCommon* myVDBComponent, distancePoint position, wxWindow* windowParent, sVdb7SegInformation* information, double angle) :
         cWXVdbBase(myVDBComponent, position, windowParent, information, distanceSize(deviceWidth, deviceHeight), angle)
     {
         Connect(wxEVT_PAINT, wxPaintEventHandler(cWXVdb7SegmentDisplay::OnPaint));
-
-        // Use a specific Bind due to bug inside of wxWidgets, see 
-        // https://stackoverflow.com/questions/38833116/conversion-in-derived-class-inaccessible-if-base-class-is-protected
-        windowParent->Bind(wxEVT_7SegmentDisplay, std::bind(&cWXVdb7SegmentDisplay::onEvent, this, std::placeholders::_1), myVDBComponent->getID());
     }
 
     /**
@@ -76,30 +69,28 @@ namespace GUI {
      * it is registered to. This shall be the cVdb7SegmentDisplay and the 
      * received event is sevenSegmentDisplayUpdate.
      * 
-     * The corresponding event is translated to an integer and 
-     * placed in the wxCommandEvent. This is then posted to 
-     * the GUI thread, which runs the onEvent function.
+     * The new value is posted to the vdb event channel, which 
+     * passes it to the onGuiEvent function in the GUI thread.
      * 
      * @note this function runs in the verilated context.
      */
     void cWXVdb7SegmentDisplay::notify(eEvent aEvent, void* data)
     {
-        _value = *reinterpret_cast<uint8_t*>(data);
-        wxCommandEvent sevenSegmentDisplayEvent{wxEVT_7SegmentDisplay, getIntID()};
-        wxPostEvent(this, sevenSegmentDisplayEvent);
+        postGuiEvent(aEvent, cVdb7SegmentDisplay::payload(data));
     }
 
     /**
      * @brief Handle the event
-     * @details This function handles the wxEVT_7SegmentDisplay event
+     * @details This function handles the update events from the event channel
      * 
      * The event is sent when the 7-Segment Display has changed state.
-     * The data is already in _value, so we simply refresh the widget
+     * Store the new value and refresh the widget
      * 
      * @note This function runs in the GUI thread
      */
-    void cWXVdb7SegmentDisplay::onEvent(wxCommandEvent& event)
+    void cWXVdb7SegmentDisplay::onGuiEvent(eEvent aEvent, uint32_t value)
     {        
+        _value = value;
         Refresh();
     }
 
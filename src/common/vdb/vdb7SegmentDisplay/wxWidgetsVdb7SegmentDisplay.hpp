@@ -49,8 +49,6 @@
 #include "wxWidgetsVdbBase.hpp"
 #include "vdb7SegmentDisplay.hpp"
 
-wxDECLARE_EVENT(wxEVT_7Segment, wxCommandEvent);
-
 namespace RoaLogic {
     using namespace observer;
     using namespace vdb;
@@ -65,8 +63,8 @@ namespace GUI {
      * This class subscribes to it's VDB component and awaits any events.
      * Corresponding events are received in the notify function, which runs in
      * the verilated context. GUI adjustments have to be done in the GUI thread,
-     * so a wxEvent is sent and following the thread switch then processed in the
-     * on7SegmentEvent function.
+     * so the new value is posted to the vdb event channel and following the thread
+     * switch then processed in the onGuiEvent function.
      * 
      * The 7-Segment Display is drawn in the OnPaint function, which also defines
      *  what the 7-Segment Display looks like
@@ -74,7 +72,7 @@ namespace GUI {
     class cWXVdb7SegmentDisplay : public cWXVdbBase
     {
         private:
-        uint8_t _value;
+        uint8_t _value = 0;
 
         static inline wxColour  colBackground = wxColour(138,150,168);            //Grey-blue
         static inline wxColour  colLedOn      = wxColour(255,0,0);                //Red
@@ -101,10 +99,10 @@ namespace GUI {
 
 	/**
          * @brief Handle the event
-         * @details This function handles the wxEVT_7SegmentDisplay event
+         * @details This function handles the update events from the event channel
          * @note This function runs in the GUI thread
          */
-        void onEvent(wxCommandEvent& event);
+        void onGuiEvent(eEvent aEvent, uint32_t value);
 
         public:
 	/**
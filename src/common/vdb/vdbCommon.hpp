@@ -92,19 +92,55 @@
  * their scope are stored statically, which is automaticcaly done during class 
  * creation and destruction. 
  * 
- * DPI functions must call the processVerilatorEvent() with the scope of the 
- * event and possible event data. It traverses all the components to find 
- * the related scope, when found it calls the virtual verilatorCallback()
- * function. In this function it has changed the context and we are now 
- * inside the class of the vdb component with the related event data. Since 
- * the verilatorCallback() function is pure virtual the derived class
- * determines the implementation of the vdb component.
+ * A vdb component derives from the cVDBComponent template, see vdbComponent.hpp,
+ * with the component class itself as template parameter. This registers the 
+ * component in a table per component type, indexed by the ID of the component.
+ * DPI functions call cVDBComponent::dispatch() with the ID, or for components
+ * that need the verilated scope with the scope of the event. The handler of 
+ * the event is given as template parameter together with its typed arguments,
+ * so the call is bound at compile time. The handler is a normal member function
+ * of the component, there is no virtual call or event decoding involved.
+ * 
+ * When dispatched by ID the scope is not needed, the DPI import then doesn't 
+ * have to be declared as context, which allows verilator to optimize the call.
+ * The ID given to the C++ class must be the same as the ID parameter of the 
+ * system verilog instance. Such a component is constructed with eDispatch::byID,
+ * it doesn't look up its scope, as verilator only creates a scope for instances
+ * with a context import or export. It is resynced through the instance table of
+ * its type instead of the scope registry.
+ * 
+ * When the model is verilated with multiple threads (make THREADS=<n>), DPI 
+ * functions can be called from any of the verilator worker threads. The testbench
+ * is then built with VDB_SIM_THREADS defined, in that case the registry is 
+ * protected by a shared mutex and the event handlers of a component are 
+ * serialized by a per component mutex. Different components can still handle 
+ * their events in parallel. In a single threaded build both locks compile away.
+ * 
+ * During a fast forward the notifications of all components are suspended, see
+ * suspendNotifications(). The components keep track of their state while 
+ * suspended, but don't notify their observers. When the notifications are resumed
+ * every component is asked to resync() its observers with its current state. A 
+ * component that holds state shall therefore implement resync().
+ * 
+ * Output values of the design can change several times within one time step,
+ * for example by combinational glitches. A component that reports a value 
+ * can therefore defer its notification with markPending(). The board calls
+ * commitPending() after each evaluation of the design, which calls commit() of
+ * every pending component once its value is stable for the settling window, see
+ * setSettlingWindow(). By default the window is 0 and the last value of the
+ * time step is committed. The component compares the value with the last 
+ * committed one in commit(), so an unchanged value doesn't notify the observers.
+ * The number of received and committed values is kept, see reportFilter().
+ * 
+ * The state of a component can be stored in a checkpoint of the board, 
+ * together with the verilated model. A component that holds state shall
+ * implement saveState() and restoreState() for this.
  * 
  * @note DPI functions shall be placed within the *.cpp file of the corresponding
  * implementation. In this way the DPI functions are private and are not called
  * within the design.
  * 
- * @attention Every DPI function must call the processVerilatorEvent() function
+ * @attention Every DPI function must call the cVDBComponent::dispatch() function
  * so that the system can handle the event accordingly.
  * 
  * @section vdbComponent_3 virtual development board component UI common
@@ -143,12 +179,12 @@
  * 
  * @subsection Verilated component
  * A new VDB component which communicates with the verilated design is created by 
- * deriving from the cVDBCommon base class. The new class must then implement the 
- * void verilatorCallback(uint32_t event) function, which is called when an event 
- * from the verilated context occurs. In cases where it expects an event from the
+ * deriving from the cVDBComponent template, with the new class and the type of 
+ * the data that is passed to the observers. The new class implements a handler
+ * per event from the verilated context. In cases where it expects an event from the
  * GUI, it must also implement the void cppEvent(uint32_t event) function. Eventual
- * DPI functions are placed in the cpp file and shall call the verilatorCallback 
- * function, see example below. If there is a GUI component (which must register 
+ * DPI functions are placed in the cpp file and shall dispatch the event to the
+ * handler, see example below. If there is a GUI component (which must register 
  * to the VDB component), we can notify it. If there is no component listening, 
  * the event will be ignored.
  * 
@@ -159,13 +195,15 @@
  * {
  * namespace vdb 
  * {
- *     class cMyNewVDBComponent : public cVDBCommon
+ *     class cMyNewVDBComponent : public cVDBComponent<cMyNewVDBComponent, sMyEventData>
  *     {
  *         private:
- *         // Define the verilator callback function
- *         void verilatorCallback(uint32_t event);
+ *         sMyEventData _myEventData;
  *
  *         public:
+ *         // Define the handler of the verilated event
+ *         void onMyEvent(uint32_t value);
+ *
  *         // The constructor must have the scopename
  *         cMyNewVDBComponent(std::string scopeName, uint8_t id); 
  *         ~cMyNewVDBComponent();
@@ -178,11 +216,10 @@
  * @code {.c++}
  * 
  * // This function is a implementation of the DPI function declared in the system verilog code
- * void myNewVDBComponentDPIFunction
+ * void myNewVDBComponentDPIFunction(int id, int myValue)
  * {
- *      // It calls the processVerilatorEvent function with the scope of the DPI function and
- *      // the value which is passed into the corresponding verilatorCallback function.
- *      cVDBCommon::processVerilatorEvent(svGetScope(), myValue);
+ *      // It dispatches the value to the handler of the component with this ID
+ *      cMyNewVDBComponent::dispatch<&cMyNewVDBComponent::onMyEvent>(id, myValue);
  * }
  * 
  * namespace RoaLogic
@@ -190,9 +227,9 @@
  *   using namespace observer;
  * namespace vdb
  * {
- *      // Construct the new class, internally everything is done within the cVDBCommon constructor
+ *      // Construct the new class, internally everything is done within the cVDBComponent constructor
  *      cMyNewVDBComponent::cMyNewVDBComponent(std::string scopeName, uint8_t id) :
- *          cVDBCommon(scopeName, id)
+ *          cVDBComponent(scopeName, id)
  *      {
  *          
  *      } 
@@ -202,12 +239,12 @@
  * 
  *      }
  * 
- *     void cMyNewVDBComponent::verilatorCallback(uint32_t event)
+ *     void cMyNewVDBComponent::onMyEvent(uint32_t value)
  *     {
  *          // Handle the verilated event, which is up to the class to handle
  * 
  *          // In case there is a GUI element, notify the observer and pass it the data
- *          notifyObserver(eEvent::myNewEvent, myEventDataPointer);
+ *          notifyObserver(eEvent::myNewEvent, &_myEventData);
  *     }
  * 
  * }
@@ -223,12 +260,13 @@
  * constructor takes a pointer to the VDB verilatored component, which can be given as nullptr in
  * case it is not used. The class will internally register to the VDB component and receive the
  * corresponding events in the notify() function. Since this function is specific to the component
- * it is virtual and shall be overwritten by the derived class. The constructor also takes a 
- * distancePoint, which translates to the position on the GUI screen. This position is relative
- * in dimension to the top left corner of the board screen. See @ref <add ref> for more information.
- * It is possible in some cases that the GUI has to clean up when the system is closed or restarted,
- * for this reason there is a virtual onClose() function. This function is called when the component
- * is closed to clean up, which is also depend on the implemented class.
+ * it is virtual and shall be overwritten by the derived class. The data of an event is read with 
+ * the static payload() function of the vdb component class, which returns it with its own type. The
+ * constructor also takes a distancePoint, which translates to the position on the GUI screen. This
+ * position is relative in dimension to the top left corner of the board screen. See @ref <add ref>
+ * for more information. It is possible in some cases that the GUI has to clean up when the system
+ * is closed or restarted, for this reason there is a virtual onClose() function. This function is
+ * called when the component is closed to clean up, which is also depend on the implemented class.
  * 
  * Example class definition:
  * @code {.c++}
@@ -294,13 +332,24 @@
 #include "log.hpp"
 #include "testbench.hpp"
 #include "subject.hpp"
+#include "verilated_save.h"
 
 #ifndef VDB_COMMON_HPP
 #define VDB_COMMON_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#ifdef VDB_SIM_THREADS
+#include <mutex>
+#include <shared_mutex>
+#endif
+
 namespace RoaLogic
 {
     using namespace observer;
+    using namespace testbench;
 namespace vdb
 {
     /**
@@ -323,6 +372,31 @@ namespace vdb
      */
     class cVDBCommon : public cSubject
     {
+        protected:
+#ifdef VDB_SIM_THREADS
+        typedef std::shared_mutex                   tRegistryMutex;
+        typedef std::unique_lock<std::shared_mutex> tRegistryWriteLock;
+        typedef std::shared_lock<std::shared_mutex> tRegistryReadLock;
+        typedef std::mutex                          tCallbackMutex;
+        typedef std::lock_guard<std::mutex>         tCallbackLock;
+#else
+        /**
+         * @brief Lock placeholder for single threaded models
+         */
+        struct sNoLock
+        {
+            sNoLock() {}
+            template <class T> explicit sNoLock(T&) {}
+        };
+        typedef sNoLock tRegistryMutex;
+        typedef sNoLock tRegistryWriteLock;
+        typedef sNoLock tRegistryReadLock;
+        typedef sNoLock tCallbackMutex;
+        typedef sNoLock tCallbackLock;
+#endif
+
+        static tRegistryMutex _registryMutex;           //!< Protects the component registries
+
         private:
         /**
          * @brief Structure to hold the scope and
@@ -334,8 +408,29 @@ namespace vdb
             cVDBCommon* reference;  //!< Pointer to the component
         };
         static std::vector<sVdbMap> _referencePointers; //!< Static vector for all maps
+        static std::vector<void (*)()> _resyncTables;   //!< Resync functions of the instance tables of ID dispatched types
+        static std::atomic<bool> _suspended;            //!< Notifications to the observers are suspended
+
+        static std::vector<cVDBCommon*> _pending;       //!< Components with a value to commit
+        static tCallbackMutex _pendingMutex;            //!< Protects _pending
+        static double _settlingWindowMs;                //!< Time a value must be stable before it is committed
+        static std::atomic<uint64_t> _numReceived;      //!< Number of values received from the design
+        static uint64_t _numCommitted;                  //!< Number of values that notified the observers
+
+        bool   _isPending = false;  //!< The component is in the _pending list
+        bool   _changed = false;    //!< A value was received since the last commitPending()
+        double _changeTimeMs = 0;   //!< Time of the last received value
 
         protected:
+        /**
+         * @brief How the events of a component are dispatched
+         */
+        enum class eDispatch
+        {
+            byScope,    //!< By the verilated scope, the component is registered with its scope
+            byID        //!< By the ID, the component has no verilated scope
+        };
+
         /**
          * @brief register a vdb component
          * @details This function registers a map of the
@@ -346,6 +441,7 @@ namespace vdb
          */
         static void registerVdb(sVdbMap map)
         {
+            tRegistryWriteLock lock(_registryMutex);
             _referencePointers.push_back(map);
         }
 
@@ -360,6 +456,7 @@ namespace vdb
          */
         static void unregisterVdb(sVdbMap map)
         {
+            tRegistryWriteLock lock(_registryMutex);
             uint32_t iterator = 0;
 
             for(auto ref : _referencePointers)
@@ -375,47 +472,216 @@ namespace vdb
             }
         }
 
-        public:
         /**
-         * @brief Process a verilator event
-         * @details This function shall be called from a verilated DPI
-         * function. It takes the scope of the event and the value of the
-         * event (which is specific to each component). 
+         * @brief Register the resync function of an instance table
+         * @details Used for the components that are dispatched by ID, the
+         * function resyncs every instance of the type. A function is only 
+         * registered once.
          * 
-         * Traverse the full list of registered components and see if we
-         * can find the scope. When the scope is found the virtual 
-         * verilatorCallback function is called with the corresponding
-         * event code.
+         * @attention The caller shall hold a tRegistryWriteLock on the 
+         * _registryMutex
          * 
-         * @param[in] scope     The verilated scope of the event
-         * @param[in] event     The event which happend (specific to the component)
-         */        
-        static void processVerilatorEvent(svScope scope, uint32_t event)
+         * @param[in] resyncTable   The resync function of the table
+         */
+        static void registerResyncTable(void (*resyncTable)())
         {
-            bool found = false;
+            if(std::find(_resyncTables.begin(), _resyncTables.end(), resyncTable) == _resyncTables.end())
+            {
+                _resyncTables.push_back(resyncTable);
+            }
+        }
 
-            // Loop all registered vdb components
+        /**
+         * @brief Find a vdb component by scope
+         * @details Traverse the full list of registered components and 
+         * see if we can find the scope.
+         * 
+         * @attention The caller shall hold a tRegistryReadLock on the 
+         * _registryMutex while the returned component is used
+         * 
+         * @param[in] scope     The verilated scope of the component
+         * @return The component, nullptr when the scope is not registered
+         */
+        static cVDBCommon* findComponent(svScope scope)
+        {
             for (const sVdbMap& ref : _referencePointers)
             {
-                // Check if we found the component
                 if(ref.scope == scope)
                 {
-                    // Call the callback with the event value
-                    ref.reference->verilatorCallback(event);
-                    found = true;
-                    break;
+                    return ref.reference;
+                }
+            }
+
+            return nullptr;
+        }
+
+        public:
+        /**
+         * @brief Suspend the notifications of all components
+         * @details Used to fast forward the design, the components
+         * keep track of their state but don't notify their observers.
+         * 
+         * @note Shall be called from the verilator thread
+         */
+        static void suspendNotifications()
+        {
+            _suspended.store(true, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Resume the notifications of all components
+         * @details Every registered component resyncs its observers 
+         * with its current state in a single pass.
+         * 
+         * @note Shall be called from the verilator thread, between 
+         * two evaluations of the design
+         */
+        static void resumeNotifications()
+        {
+            _suspended.store(false, std::memory_order_relaxed);
+            resyncObservers();
+        }
+
+        /**
+         * @brief Resync the observers of all components
+         * @details Every registered component notifies its observers
+         * with its current state.
+         * 
+         * @note Shall be called from the verilator thread, between 
+         * two evaluations of the design
+         */
+        static void resyncObservers()
+        {
+            tRegistryReadLock lock(_registryMutex);
+
+            for (const sVdbMap& ref : _referencePointers)
+            {
+                tCallbackLock callbackLock(ref.reference->_callbackMutex);
+                ref.reference->resync();
+            }
+
+            for (void (*resyncTable)() : _resyncTables)
+            {
+                resyncTable();
+            }
+        }
+
+        /**
+         * @brief Check if the notifications are suspended
+         * 
+         * @return true when the components shall not notify their observers 
+         */
+        static bool notificationsSuspended()
+        {
+            return _suspended.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Set the settling window
+         * @details A received value is only committed when no new value is 
+         * received within this window. With a window of 0 the last value of 
+         * each time step is committed.
+         * 
+         * @param[in] window    The settling window in simulation time
+         */
+        static void setSettlingWindow(simtime_t window)
+        {
+            _settlingWindowMs = window.ms();
+        }
+
+        /**
+         * @brief Commit the values of the pending components
+         * @details Every pending component whose value is stable for the 
+         * settling window is committed, the others stay pending.
+         * 
+         * @note Shall be called from the verilator thread, after an 
+         * evaluation of the design
+         * 
+         * @param[in] now   The current simulation time
+         */
+        static void commitPending(simtime_t now)
+        {
+            if(_pending.empty())
+            {
+                return;
+            }
+
+            const double nowMs = now.ms();
+            size_t keep = 0;
+
+            for(cVDBCommon* component : _pending)
+            {
+                if(component->_changed)
+                {
+                    component->_changed = false;
+                    component->_changeTimeMs = nowMs;
+                }
+
+                if(nowMs - component->_changeTimeMs >= _settlingWindowMs)
+                {
+                    component->_isPending = false;
+                    _numCommitted += component->commit() ? 1 : 0;
+                }
+                else
+                {
+                    _pending[keep++] = component;
                 }
             }
 
-            if(!found)
+            _pending.resize(keep);
+        }
+
+        /**
+         * @brief Report the statistics of the filter
+         * @details Logs the number of received values and the number of 
+         * values that notified the observers.
+         */
+        static void reportFilter()
+        {
+            uint64_t received = _numReceived.load(std::memory_order_relaxed);
+
+            if(received > 0)
             {
-                WARNING << "VDB: Event on non registered module: " << svGetNameFromScope(scope) << " \n";
+                INFO << "VDB filter: " << received << " values received, " << _numCommitted 
+                     << " notified, " << received - _numCommitted << " suppressed\n";
             }
         }
 
+        protected:
+        /**
+         * @brief Mark that the component received a new value
+         * @details The component is committed by commitPending(), at the
+         * end of the time step or after the settling window.
+         * 
+         * @note Shall be called from the event handler of the component
+         */
+        void markPending()
+        {
+            _numReceived.fetch_add(1, std::memory_order_relaxed);
+            _changed = true;
+
+            if(!_isPending)
+            {
+                tCallbackLock lock(_pendingMutex);
+                _isPending = true;
+                _pending.push_back(this);
+            }
+        }
+
+        /**
+         * @brief Commit the last received value
+         * @details Derived classes that use markPending() shall compare the
+         * value with the last committed value, and only notify the observers
+         * when it changed.
+         * 
+         * @return true when the observers are notified
+         */
+        virtual bool commit(){ return false; }
+
         protected:
         size_t  _myID;           //!< The ID of the vdb component
         svScope _myScope;        //!< The scope of the verilated context
+        tCallbackMutex _callbackMutex;  //!< Serializes the event handlers of this component
 
         public:
         /**
@@ -424,14 +690,22 @@ namespace vdb
          *
          * First the scope is set according to the given name, where it is
          * also checked that the scope exists. When this is ok, it registers
-         * this class for any verilator actions.
+         * this class for any verilator actions. A component that is dispatched
+         * by ID has no scope and is not registered here.
          *
          * @param[in] scopeName     Scope of this vdb component
          * @param[in] id            Optional ID of the component
+         * @param[in] dispatch      How the events of the component are dispatched
          */
-        cVDBCommon(std::string scopeName, size_t id) : 
-            _myID(id)
+        cVDBCommon(std::string scopeName, size_t id, eDispatch dispatch = eDispatch::byScope) : 
+            _myID(id),
+            _myScope(nullptr)
         {
+            if(dispatch == eDispatch::byID)
+            {
+                return;
+            }
+
             // Get the scope according to the given name
             _myScope = svGetScopeFromName(scopeName.c_str());
             svSetScope(_myScope);
@@ -450,7 +724,16 @@ namespace vdb
          */
         virtual ~cVDBCommon()
         {
-            unregisterVdb(sVdbMap{_myScope, this});
+            if(_myScope)
+            {
+                unregisterVdb(sVdbMap{_myScope, this});
+            }
+
+            if(_isPending)
+            {
+                tCallbackLock lock(_pendingMutex);
+                std::erase(_pending, this);
+            }
         }
 
         /**
@@ -460,19 +743,6 @@ namespace vdb
          */
         size_t getID(){return _myID;};
 
-        /**
-         * @brief Verilator function callback
-         * @details This function is called when an
-         * event occurs for this vdb component. In this function
-         * we are in the class and have all knowledge needed.
-         * 
-         * The event data is specific per component, where it
-         * is just passed as uint32_t.
-         * 
-         * @param[in] event The event data for the handler
-         */
-        virtual void verilatorCallback(uint32_t event) = 0;
-
         /**
          * @brief Callback function from the C++ side
          * @details This function is called when an event
@@ -488,9 +758,62 @@ namespace vdb
          * @param[in] event     The event data 
          */
         virtual void cppEvent(uint32_t event){};
+
+        /**
+         * @brief Resync the observers
+         * @details This function is called when the notifications are
+         * resumed. Derived classes that hold state shall notify their
+         * observers with the current state.
+         */
+        virtual void resync(){};
+
+        /**
+         * @brief Save the component state into a checkpoint
+         * 
+         * @param[in] os    The checkpoint stream
+         */
+        virtual void saveState(VerilatedSerialize& os){};
+
+        /**
+         * @brief Restore the component state from a checkpoint
+         * @details Shall read the same data as saveState() writes.
+         * 
+         * @param[in] os    The checkpoint stream
+         */
+        virtual void restoreState(VerilatedDeserialize& os){};
+
+        /**
+         * @brief Encode the data of an event into a value
+         * @details Used by the event recorder. Components whose event data 
+         * fits in 32 bits return it as value, the events of other components 
+         * are not recorded.
+         * 
+         * @param[in]  data     The data pointer passed with notifyObserver()
+         * @param[out] value    The encoded data
+         * 
+         * @return false when the data can't be encoded
+         */
+        virtual bool encodePayload(const void* data, uint32_t& value){ return false; };
+
+        /**
+         * @brief Notify the observers with a recorded value
+         * @details Used by the event replay, the reverse of encodePayload().
+         * 
+         * @param[in] aEvent    The recorded event
+         * @param[in] value     The recorded value
+         */
+        virtual void replayPayload(eEvent aEvent, uint32_t value){};
     };
 
     inline std::vector<cVDBCommon::sVdbMap> cVDBCommon::_referencePointers;
+    inline std::vector<void (*)()> cVDBCommon::_resyncTables;
+    inline cVDBCommon::tRegistryMutex cVDBCommon::_registryMutex;
+    inline std::atomic<bool> cVDBCommon::_suspended = false;
+    inline std::vector<cVDBCommon*> cVDBCommon::_pending;
+    inline cVDBCommon::tCallbackMutex cVDBCommon::_pendingMutex;
+    inline double cVDBCommon::_settlingWindowMs = 0;
+    inline std::atomic<uint64_t> cVDBCommon::_numReceived = 0;
+    inline uint64_t cVDBCommon::_numCommitted = 0;
 }
 }
 
@@ -0,0 +1,270 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Virtual Devboard typed component C++ header file             //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "vdbCommon.hpp"
+
+#ifndef VDB_COMPONENT_HPP
+#define VDB_COMPONENT_HPP
+
+#include <type_traits>
+#include <vector>
+
+namespace RoaLogic
+{
+namespace vdb
+{
+    /**
+     * @class cVDBComponent
+     * @brief Statically typed virtual development board component
+     * @version 0.1
+     * @date 16-oct-2026
+     * @details
+     * 
+     * This is the base class for a virtual development board component, tDerived
+     * is the component class itself and tPayload the type of the data that is 
+     * passed to the observers.
+     * 
+     * Each component type has its own table of instances, indexed by the ID of the
+     * component. A DPI function dispatches an event with the dispatch() function,
+     * where the handler of the event is given as template parameter. The handler
+     * is a member function of tDerived and is called with the typed arguments of 
+     * the DPI function. Because the handler is known at compile time it is a 
+     * direct call, without a virtual function or decoding of the event.
+     * 
+     * The registration is done in the constructor and destructor of this class, 
+     * the ID of the component must be the ID parameter of the verilated instance.
+     * A component dispatched by scope is registered with its scope instead.
+     * 
+     * Events with an integral payload of at most 32 bits can be recorded and 
+     * replayed, see encodePayload() and replayPayload().
+     * 
+     * @note The handlers are serialized per component, also when the model
+     * is verilated with multiple threads.
+     */
+    template <class tDerived, class tPayload>
+    class cVDBComponent : public cVDBCommon
+    {
+        private:
+        static inline std::vector<tDerived*> _instances;   //!< Instances of this type, indexed by ID
+
+        /**
+         * @brief Call the handler of a component
+         * @details The registry read lock shall be held by the caller
+         */
+        template <auto tHandler, class... tArgs>
+        static void callHandler(tDerived* component, tArgs... args)
+        {
+            tCallbackLock callbackLock(component->_callbackMutex);
+            (component->*tHandler)(args...);
+        }
+
+        /**
+         * @brief Resync the observers of all instances of this type
+         * @details The registry read lock shall be held by the caller
+         */
+        static void resyncInstances()
+        {
+            for(tDerived* component : _instances)
+            {
+                if(component)
+                {
+                    tCallbackLock callbackLock(component->_callbackMutex);
+                    static_cast<cVDBCommon*>(component)->resync();
+                }
+            }
+        }
+
+        protected:
+        /**
+         * @brief Construct a new cVDBComponent object
+         * @details A component dispatched by scope is registered with its 
+         * scope through cVDBCommon, a component dispatched by ID in the 
+         * instance table of its type.
+         * 
+         * @param[in] scopeName     Scope of this vdb component
+         * @param[in] id            ID of the component, must match the ID parameter of the instance
+         * @param[in] dispatch      How the events of the component are dispatched
+         */
+        cVDBComponent(std::string scopeName, size_t id, eDispatch dispatch = eDispatch::byScope) :
+            cVDBCommon(scopeName, id, dispatch)
+        {
+            if(dispatch != eDispatch::byID)
+            {
+                return;
+            }
+
+            tRegistryWriteLock lock(_registryMutex);
+            registerResyncTable(&cVDBComponent::resyncInstances);
+
+            if(_instances.size() <= id)
+            {
+                _instances.resize(id + 1, nullptr);
+            }
+
+            if(_instances[id] != nullptr)
+            {
+                WARNING << "VDB: ID " << id << " is registered twice\n";
+            }
+
+            _instances[id] = static_cast<tDerived*>(this);
+        }
+
+        /**
+         * @brief destruct the cVDBComponent object
+         * @details Unregister this component so that it's not called anymore
+         */
+        ~cVDBComponent()
+        {
+            tRegistryWriteLock lock(_registryMutex);
+
+            if(_myID < _instances.size() && _instances[_myID] == static_cast<tDerived*>(this))
+            {
+                _instances[_myID] = nullptr;
+            }
+        }
+
+        public:
+        /**
+         * @brief Dispatch a verilator event by component ID
+         * @details This function shall be called from a verilated DPI
+         * function. The component is looked up directly in the instance 
+         * table, so the DPI import doesn't need to be a context import.
+         * 
+         * @note This function can be called from any verilator worker thread
+         * 
+         * @param[in] id        The ID of the component, the ID parameter of the instance
+         * @param[in] args      The arguments of the handler
+         */
+        template <auto tHandler, class... tArgs>
+        static void dispatch(size_t id, tArgs... args)
+        {
+            tRegistryReadLock lock(_registryMutex);
+            tDerived* component = id < _instances.size() ? _instances[id] : nullptr;
+
+            if(component)
+            {
+                callHandler<tHandler>(component, args...);
+            }
+            else
+            {
+                WARNING << "VDB: Event on non registered ID: " << id << " \n";
+            }
+        }
+
+        /**
+         * @brief Dispatch a verilator event by scope
+         * @details For components whose handler needs the scope of the 
+         * verilated instance, the DPI import is then a context import.
+         * 
+         * @param[in] scope     The verilated scope of the event
+         * @param[in] args      The arguments of the handler
+         */
+        template <auto tHandler, class... tArgs>
+        static void dispatch(svScope scope, tArgs... args)
+        {
+            tRegistryReadLock lock(_registryMutex);
+            cVDBCommon* component = findComponent(scope);
+
+            if(component)
+            {
+                callHandler<tHandler>(static_cast<tDerived*>(component), args...);
+            }
+            else
+            {
+                WARNING << "VDB: Event on non registered module: " << svGetNameFromScope(scope) << " \n";
+            }
+        }
+
+        /**
+         * @brief Get the data of an event of this component
+         * @details Used by the observers to read the data passed 
+         * with notifyObserver()
+         * 
+         * @param[in] data      The data pointer received in notify()
+         * @return The data with its own type
+         */
+        static const tPayload& payload(const void* data)
+        {
+            return *static_cast<const tPayload*>(data);
+        }
+
+        /**
+         * @brief Encode the data of an event into a value
+         * 
+         * @param[in]  data     The data pointer passed with notifyObserver()
+         * @param[out] value    The encoded data
+         * 
+         * @return false when the payload isn't an integral of at most 32 bits
+         */
+        bool encodePayload(const void* data, uint32_t& value)
+        {
+            if constexpr (std::is_integral_v<tPayload> && sizeof(tPayload) <= sizeof(uint32_t))
+            {
+                value = static_cast<uint32_t>(payload(data));
+                return true;
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Notify the observers with a recorded value
+         * 
+         * @param[in] aEvent    The recorded event
+         * @param[in] value     The recorded value
+         */
+        void replayPayload(eEvent aEvent, uint32_t value)
+        {
+            if constexpr (std::is_integral_v<tPayload> && sizeof(tPayload) <= sizeof(uint32_t))
+            {
+                tPayload data = static_cast<tPayload>(value);
+                notifyObserver(aEvent, &data);
+            }
+        }
+    };
+}
+}
+
+#endif
@@ -45,6 +45,9 @@
 
 #include "vdbLED.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace RoaLogic::vdb;
 
 //#define DBG_VDB_LED
@@ -54,7 +57,7 @@ using namespace RoaLogic::vdb;
  * @details This function gets called when the LED 
  * state in the design changes state to on.
  * 
- * It will pass it's event to the handleLedEvent so that it 
+ * It will pass it's event to the LED with the same ID so that it 
  * can be processed correctly within the virtual led class.
  * 
  * @attention This function runs in the verilator thread context
@@ -62,10 +65,10 @@ using namespace RoaLogic::vdb;
 void vdbLedOn(int id)
 {
     #ifdef DBG_VDB_LED
-    INFO << "LED: On event: " << svGetScope() << "\n";
+    INFO << "LED: On event: " << id << "\n";
     #endif
-    // Get the scope of the current call and pass this into the processing function
-    cVDBCommon::processVerilatorEvent(svGetScope(), static_cast<uint32_t>(cVdbLed::eVdbLedEvent::ledOn));
+    // Pass the event to the LED with this ID
+    cVdbLed::dispatch<&cVdbLed::setState>(id, true);
 }
 
 /**
@@ -73,7 +76,7 @@ void vdbLedOn(int id)
  * @details This function gets called when the LED 
  * state in the design changes state to off.
  * 
- * It will pass it's event to the handleLedEvent so that it 
+ * It will pass it's event to the LED with the same ID so that it 
  * can be processed correctly within the virtual led class.
  * 
  * @attention This function runs in the verilator thread context
@@ -81,10 +84,10 @@ void vdbLedOn(int id)
 void vdbLedOff(int id)
 {
     #ifdef DBG_VDB_LED
-    INFO << "LED: Off event: " << svGetScope() << "\n";
+    INFO << "LED: Off event: " << id << "\n";
     #endif
-    // Get the scope of the current call and pass this into the processing function
-    cVDBCommon::processVerilatorEvent(svGetScope(), static_cast<uint32_t>(cVdbLed::eVdbLedEvent::ledOff));
+    // Pass the event to the LED with this ID
+    cVdbLed::dispatch<&cVdbLed::setState>(id, false);
 }
 
 
@@ -97,18 +100,23 @@ namespace vdb
      * @brief Construct a new cVdbLed object
      * @details This constructer creates a new cVdbLed object
      * 
-     * First the scope is set according to the given name, where it is 
-     * also checkd that the scope exists. When this is ok, it registers
-     * this class for any verilator actions.
+     * The events of the LED are dispatched by ID, so it registers this
+     * class by its ID. The verilated instance has no scope, the scope 
+     * name is only used for debugging.
      * 
      * @param[in] scopeName     Scope of this LED
-     * @param[in] id            Optional ID of this led (mainly used for debugging)
+     * @param[in] id            ID of this led, must match the ID parameter of the instance
+     * @param[in] timeInterface Pointer to the time interface, used to time the edges
      */
-    cVdbLed::cVdbLed(std::string scopeName, uint8_t id) :
-        cVDBCommon(scopeName, id)
+    cVdbLed::cVdbLed(std::string scopeName, uint8_t id, cTimeInterface* timeInterface) :
+        cVDBComponent(scopeName, id, eDispatch::byID),
+        _timeInterface(timeInterface),
+        _intervalMs(cDefaultInterval * 1000.0)
     {
+        assert(timeInterface != nullptr);
+
         #ifdef DBG_VDB_LED
-        INFO << "LED: Create: ID " << id << " Scope: "<< svGetScope() << "\n";
+        INFO << "LED: Create: ID " << id << " Scope: "<< scopeName << "\n";
         #endif
     }
 
@@ -123,32 +131,160 @@ namespace vdb
     }
 
     /**
-     * @brief Callback function for a verilated LED event
+     * @brief Handler for a verilated LED event
      * @details This function handles the LED on and off events coming
-     * from the verilated design. It checks if the event is alright and
-     * then notifies all classes which are registered to it.
+     * from the verilated design. The on time up to this edge is added to
+     * the current interval, when the interval has ended it is closed first.
      * 
-     * @param[in] event     The event which occured, shall be a eVdbLedEvent type
+     * @param[in] isOn      The new state of the LED
      */
-    void cVdbLed::verilatorCallback(uint32_t event)
+    void cVdbLed::setState(bool isOn)
     {
+        double nowMs = _timeInterface->getTime().ms();
+
         #ifdef DBG_VDB_LED
-        INFO << "LED: Received led " << _myID << " event: " << event << "\n";
+        INFO << "LED: Received led " << _myID << " state: " << isOn << " at " << nowMs << "ms\n";
         #endif
 
-        switch (static_cast<eVdbLedEvent>(event))
+        integrate(nowMs);
+
+        if(nowMs - _windowStartMs >= _intervalMs)
+        {
+            closeWindow(nowMs);
+        }
+
+        _isOn = isOn;
+    }
+
+    /**
+     * @brief Add the on time since the last edge to the current interval
+     * 
+     * @param[in] nowMs     The current simulation time
+     */
+    void cVdbLed::integrate(double nowMs)
+    {
+        if(_isOn && nowMs > _lastEdgeMs)
+        {
+            _onTimeMs += nowMs - _lastEdgeMs;
+        }
+
+        _lastEdgeMs = nowMs;
+    }
+
+    /**
+     * @brief Close the current interval
+     * @details The brightness is the on time relative to the length of the 
+     * interval. Observers are only notified when the brightness changed, 
+     * while the notifications are suspended only the brightness is stored.
+     * 
+     * @param[in] nowMs     The end of the interval, the start of the next
+     */
+    void cVdbLed::closeWindow(double nowMs)
+    {
+        double windowMs = nowMs - _windowStartMs;
+        uint8_t brightness = _isOn ? cFullBrightness : 0;
+
+        if(windowMs > 0)
+        {
+            brightness = static_cast<uint8_t>(std::lround(std::min(_onTimeMs / windowMs, 1.0) * cFullBrightness));
+        }
+
+        _windowStartMs = nowMs;
+        _onTimeMs = 0;
+
+        if(brightness != _brightness)
         {
-        case eVdbLedEvent::ledOn:
-            notifyObserver(eEvent::ledChangedOn, nullptr);
-            break;
-        case eVdbLedEvent::ledOff:
-            notifyObserver(eEvent::ledChangedOff, nullptr);
-            break;
-        
-        default:
-            break;
+            _brightness = brightness;
+
+            if(!notificationsSuspended())
+            {
+                notifyObserver(eEvent::ledBrightness, &_brightness);
+            }
         }
     }
 
+    /**
+     * @brief Sample the state of the LED
+     * @details Used when the DPI functions are compiled out of the design, 
+     * see VDB_SAMPLED_OUTPUTS. A state that differs from the previous one is
+     * handled as an edge at the current time.
+     * 
+     * @note Runs in the verilator thread context
+     * 
+     * @param[in] isOn      The sampled state of the LED
+     */
+    void cVdbLed::sample(bool isOn)
+    {
+        tCallbackLock callbackLock(_callbackMutex);
+
+        if(isOn != _isOn)
+        {
+            setState(isOn);
+        }
+    }
+
+    /**
+     * @brief Close the current interval when it has ended
+     * @details Shall be called regularly between two evaluations of the 
+     * design, so that a LED that doesn't toggle is updated as well.
+     * 
+     * @note Runs in the verilator thread context
+     */
+    void cVdbLed::refresh()
+    {
+        tCallbackLock callbackLock(_callbackMutex);
+        double nowMs = _timeInterface->getTime().ms();
+
+        // The time moved backwards, e.g. after restoring a checkpoint
+        if(nowMs < _windowStartMs)
+        {
+            _windowStartMs = nowMs;
+            _lastEdgeMs = nowMs;
+            _onTimeMs = 0;
+        }
+
+        if(nowMs - _windowStartMs >= _intervalMs)
+        {
+            integrate(nowMs);
+            closeWindow(nowMs);
+        }
+    }
+
+    /**
+     * @brief Set the display interval
+     * @details The interval over which the on time is integrated, normally
+     * the refresh period of the GUI in simulation time.
+     * 
+     * @param[in] interval  The display interval
+     */
+    void cVdbLed::setDisplayInterval(simtime_t interval)
+    {
+        _intervalMs = interval.ms();
+    }
+
+    /**
+     * @brief Resync the observers with the current LED brightness
+     */
+    void cVdbLed::resync()
+    {
+        notifyObserver(eEvent::ledBrightness, &_brightness);
+    }
+
+    /**
+     * @brief Save the LED state into a checkpoint
+     */
+    void cVdbLed::saveState(VerilatedSerialize& os)
+    {
+        os << _isOn << _windowStartMs << _lastEdgeMs << _onTimeMs << _brightness;
+    }
+
+    /**
+     * @brief Restore the LED state from a checkpoint
+     */
+    void cVdbLed::restoreState(VerilatedDeserialize& os)
+    {
+        os >> _isOn >> _windowStartMs >> _lastEdgeMs >> _onTimeMs >> _brightness;
+    }
+
 }
 }
\ No newline at end of file
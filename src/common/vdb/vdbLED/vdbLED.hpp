@@ -47,12 +47,26 @@
  * @section vdbComponentLED Virtual development LED component
  *
  * LED text
+ * 
+ * The LED reports a brightness instead of every edge. The on time of the LED 
+ * is integrated over a display interval of simulation time, at the end of the
+ * interval the duty cycle is reported as brightness. A LED driven by a PWM 
+ * signal is therefore shown dimmed, while only one event per interval is sent
+ * to the GUI. A LED that is switched on or off shows full or no brightness 
+ * after at most one interval.
+ * 
+ * When the design is built with VDB_SAMPLED_OUTPUTS the LED doesn't call any
+ * DPI function. The board then samples the LED inputs from the model, and 
+ * passes them to sample(). Edges between two samples are not seen, the 
+ * brightness is integrated over the sampled states.
  */
 
 #ifndef VDB_LED_HPP
 #define VDB_LED_HPP
 
-#include "vdbCommon.hpp"
+#include "vdbComponent.hpp"
+
+using namespace RoaLogic::testbench;
 
 namespace RoaLogic
 {
@@ -68,28 +82,59 @@ namespace vdb
      * 
      * @details This class controls a verilated LED instance.
      * 
-     * It takes the verilator event through the verilator callback and notifies
+     * It takes the verilator event through the setState handler and notifies
      * anyone listening to this led. This class fully runs in the verilated context.
-     * The base is the cVDBCommon class which does all the low level handling and 
-     * setting up the callback mechanism for any DPI functions. The user shall call
-     * the cVDBCommon::processVerilatorEvent with the scope and the eventual event.
+     * The base is the cVDBComponent class which does all the low level handling and 
+     * setting up the callback mechanism for any DPI functions. The DPI functions 
+     * dispatch the new state to the LED with the ID of the instance.
+     * 
+     * The time of each edge is taken from the time interface and the on time
+     * is integrated per display interval. The observers receive the ledBrightness
+     * event when the brightness of an interval differs from the previous one, the
+     * payload is the brightness from 0 (off) to cFullBrightness.
      * 
+     * An interval is closed by the first edge after its end, or by refresh(). The
+     * board shall call refresh() regularly, so that a LED without edges is 
+     * updated as well.
      */
-    class cVdbLed : public cVDBCommon
+    class cVdbLed : public cVDBComponent<cVdbLed, uint8_t>
     {
+        friend void ::vdbLedOn(int id);
+        friend void ::vdbLedOff(int id);
+
         public:
-        enum class eVdbLedEvent
-        {
-            ledOn,
-            ledOff
-        };
+        static const uint8_t cFullBrightness = 255;        //!< Brightness of a LED that is on during a full interval
+        static constexpr long double cDefaultInterval = 1.0 / 60.0; //!< Default display interval in seconds
 
         private:
-        void verilatorCallback(uint32_t event);
+        cTimeInterface* _timeInterface;     //!< Pointer to the time interface for retrieving the current time
+        double   _intervalMs;               //!< Display interval in milliseconds of simulation time
+        bool     _isOn = false;             //!< Current state of the LED
+        double   _windowStartMs = 0;        //!< Start of the current interval
+        double   _lastEdgeMs = 0;           //!< Time of the last edge, or of the last integration
+        double   _onTimeMs = 0;             //!< On time within the current interval
+        uint8_t  _brightness = 0;           //!< Brightness of the last interval
+
+        void setState(bool isOn);
+        void integrate(double nowMs);
+        void closeWindow(double nowMs);
+        void resync();
 
         public:
-        cVdbLed(std::string scopeName, uint8_t id);
+        cVdbLed(std::string scopeName, uint8_t id, cTimeInterface* timeInterface);
         ~cVdbLed();
+
+        void saveState(VerilatedSerialize& os);
+        void restoreState(VerilatedDeserialize& os);
+
+        void sample(bool isOn);
+        void refresh();
+        void setDisplayInterval(simtime_t interval);
+
+        /**
+         * @brief Get the brightness of the last interval
+         */
+        uint8_t getBrightness() const { return _brightness; }
     };
 }
 }
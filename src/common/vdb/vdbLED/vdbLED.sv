@@ -57,13 +57,17 @@ module vdbLED
   //-----------------------
   // DPI Functions
   //
-  import "DPI-C" context function void vdbLedOn(int id);
-  import "DPI-C" context function void vdbLedOff(int id);
+  import "DPI-C" function void vdbLedOn(int id);
+  import "DPI-C" function void vdbLedOff(int id);
 
 
   //-----------------------
   // Module body
   //
+  // With VDB_SAMPLED_OUTPUTS the testbench samples the LED state
+  // from the model, no DPI functions are called.
+`ifndef VDB_SAMPLED_OUTPUTS
   always @(posedge in) vdbLedOn(ID);
   always @(negedge in) vdbLedOff(ID);
+`endif
 endmodule
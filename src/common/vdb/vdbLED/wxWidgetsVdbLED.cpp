@@ -47,9 +47,6 @@
 #include "wxGuiDistance.hpp"
 #include "distance.hpp"
 
-// Define the wxEVT_LED, which is special within this class
-wxDEFINE_EVENT(wxEVT_LED, wxCommandEvent);
-
 namespace RoaLogic {
     using namespace observer;
     using namespace dimensions;
@@ -58,54 +55,44 @@ namespace GUI {
     /**
      * @brief Construct a new wx widgets LED window
      * @details 
-     * This is the constructor for the LED window. Bind our 
-     * onLedEvent function with the ID to a wxEVT_LED event.
+     * This is the constructor for the LED window. The events of 
+     * the LED are received through the vdb event channel.
      * 
      */
     cWXVdbLed::cWXVdbLed(cVDBCommon* myVDBComponent, distancePoint position, wxWindow* windowParent, sVdbLedInformation* information, double angle) :
         cWXVdbBase(myVDBComponent, position, windowParent, information, GetDeviceSize(information), angle)
     {
         Connect(wxEVT_PAINT, wxPaintEventHandler(cWXVdbLed::OnPaint));
-
-        // Use a specific Bind due to bug inside of wxWidgets, see 
-        // https://stackoverflow.com/questions/38833116/conversion-in-derived-class-inaccessible-if-base-class-is-protected
-        windowParent->Bind(wxEVT_LED, std::bind(&cWXVdbLed::onEvent, this, std::placeholders::_1), myVDBComponent->getID());
-        //myEvtHandler->Bind(wxEVT_LED, &cWXVdbLed::onLEDEvent, this, wxID_ANY);
     }
 
     /**
      * @brief notify function from the vdb component
      * @details This function receives events from the component
      * it is registered to. This shall be the cVdbLed and the 
-     * received events are ledChangedOn and ledChangedOff. 
+     * received event is ledBrightness. 
      * 
-     * The corresponding event is translated to an integer and 
-     * placed in the wxCommandEvent. This is then posted to 
-     * the GUI thread, which runs the onLEDEvent function.
+     * The event is posted to the vdb event channel, which 
+     * passes it to the onGuiEvent function in the GUI thread.
      * 
      * @note this function runs in the verilated context.
      */
     void cWXVdbLed::notify(eEvent aEvent, void* data)
     {
-        wxCommandEvent ledEvent{wxEVT_LED, getIntID()};
-        ledEvent.SetInt(static_cast<int>(aEvent));
-        wxPostEvent(this, ledEvent);
+        postGuiEvent(aEvent, cVdbLed::payload(data));
     }
 
     /**
      * @brief Handle the LED event
-     * @details This function handles the wxEVT_LED event
+     * @details This function handles the LED events from the event channel
      * 
-     * The event is sent when the LED has changes state.
-     * The passed int is of the eEvent and can therefore
-     * be directly casted. According to this state we update
-     * our flag status and redraw the component.
+     * The event is sent when the brightness of the LED has 
+     * changed. Store the brightness and redraw the component.
      * 
      * @note This function runs in the GUI thread
      */
-    void cWXVdbLed::onEvent(wxCommandEvent& event)
+    void cWXVdbLed::onGuiEvent(eEvent aEvent, uint32_t value)
     {
-        _status = static_cast<eEvent>(event.GetInt()) == eEvent::ledChangedOn ? true : false;
+        _brightness = static_cast<uint8_t>(value);
         Refresh();
     }
 
@@ -124,10 +111,16 @@ namespace GUI {
 
         sVdbLedInformation* myInformation = reinterpret_cast<sVdbLedInformation*>(GetInformation());
 
-        wxColour ledColour = _status ? wxColour(myInformation->colour.red,
-                                                myInformation->colour.green,
-                                                myInformation->colour.blue)
-                                     : wxColour(255,223,223);
+        // Blend from the off colour to the LED colour
+        const wxColour offColour(255,223,223);
+        auto blend = [&](uint8_t on, uint8_t off)
+        {
+            return static_cast<unsigned char>(off + ((on - off) * _brightness) / cVdbLed::cFullBrightness);
+        };
+
+        wxColour ledColour = wxColour(blend(myInformation->colour.red,   offColour.Red()),
+                                      blend(myInformation->colour.green, offColour.Green()),
+                                      blend(myInformation->colour.blue,  offColour.Blue()));
 
         SetPen(wxPen(wxColour(0,0,0),1));
         SetBrush(ledColour);
@@ -49,8 +49,6 @@
 #include "wxWidgetsVdbBase.hpp"
 #include "vdbLED.hpp"
 
-wxDECLARE_EVENT(wxEVT_LED, wxCommandEvent);
-
 namespace RoaLogic {
     using namespace observer;
     using namespace vdb;
@@ -65,8 +63,8 @@ namespace GUI {
      * This class subscribes to it's VDB component and awaits any events.
      * Corresponding events are received in the notify function, which runs in
      * the verilated context. GUI adjustments have to be done in the GUI thread,
-     * so a wxEvent is sent and following the thread switch then processed in the
-     * onLedEvent function.
+     * so the event is posted to the vdb event channel and following the thread 
+     * switch then processed in the onGuiEvent function.
      * 
      * The LED is drawn in the OnPaint function, which also defines how the LED looks like
      * 
@@ -75,7 +73,7 @@ namespace GUI {
     class cWXVdbLed : public cWXVdbBase
     {
         private:
-        bool _status = false;
+        uint8_t _brightness = 0;
 
         /**
          * @brief notify function from the vdb component
@@ -86,10 +84,10 @@ namespace GUI {
 
 	/**
          * @brief Handle the event
-         * @details This function handles the wxEVT_LED event
+         * @details This function handles the LED events from the event channel
          * @note This function runs in the GUI thread
          */
-        void onEvent(wxCommandEvent& event);
+        void onGuiEvent(eEvent aEvent, uint32_t value);
 
         public:
 	/**
@@ -111,8 +109,8 @@ namespace GUI {
 
         /**
 	 * @brief Paint the widget
-	 * @details This function paints the widget. The 'LED' is turned on when _status=TRUE,
-	 *          otherwise the LED is turned off
+	 * @details This function paints the widget. The colour of the 'LED' is blended
+	 *          between the off colour and the LED colour according to _brightness
 	 */
         void OnPaint(wxPaintEvent& event);
     };
@@ -0,0 +1,90 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    VESA timing table for the VGA tests                          //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef VESA_TIMING_HPP
+#define VESA_TIMING_HPP
+
+#include <cstdint>
+
+/**
+ * @brief VGA timing of a VESA mode, in pixels and lines
+ */
+struct sVesaTiming
+{
+    uint32_t horizontalPixels;
+    uint32_t verticalPixels;
+    uint32_t frequencyHz;
+    uint32_t totalHorizontal;       // Active video + front porch + sync + back porch
+    uint32_t frontPorchHorizontal;
+    uint32_t syncHorizontal;
+    uint32_t backPorchHorizontal;
+    uint32_t totalVertical;         // Active video + front porch + sync + back porch
+    uint32_t frontPorchVertical;
+    uint32_t syncVertical;
+    uint32_t backPorchVertical;
+};
+
+/**
+ * @brief The VESA modes of the VGA monitor
+ * @details Same values as the timing table in vdbVGAMonitor.cpp, without the pixel clock
+ */
+inline constexpr sVesaTiming cVesaTiming[] =
+{
+    { 640, 480, 60,  800, 16,  96,  48, 524, 11, 2, 31},
+    { 640, 480, 72,  832, 24,  40, 128, 520,  9, 3, 28},
+    { 640, 480, 75,  800, 16,  96,  48, 524, 11, 2, 32},
+    { 640, 480, 85,  832, 32,  48, 112, 509,  1, 3, 25},
+    { 800, 600, 56, 1088, 32, 128, 128, 619,  1, 4, 14},
+    { 800, 600, 60, 1056, 40, 128,  88, 628,  1, 4, 23},
+    { 800, 600, 72, 1040, 56, 120,  64, 666, 37, 6, 23},
+    { 800, 600, 75, 1056, 16,  80, 160, 624,  1, 2, 21},
+    { 800, 600, 85, 1048, 32,  64, 152, 632,  1, 3, 27},
+    {1024, 768, 60, 1344, 24, 136, 160, 806,  3, 6, 29},
+    {1024, 768, 70, 1328, 24, 136, 144, 804,  1, 6, 29},
+    {1024, 768, 75, 1312, 16,  96, 176, 800,  1, 3, 28},
+    {1024, 768, 85, 1376, 48,  96, 208, 808,  1, 3, 36}
+};
+
+#endif // VESA_TIMING_HPP
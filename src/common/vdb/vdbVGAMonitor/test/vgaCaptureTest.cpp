@@ -0,0 +1,162 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    VGA native capture test and benchmark                        //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "vgaCapture.hpp"
+#include "vesaTiming.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/**
+ * @file vgaCaptureTest.cpp
+ * @brief Test and benchmark of the native VGA capture engine
+ * @version 0.1
+ * @date 16-oct-2026
+ * 
+ * @details A cVgaCapture is driven with the sync and RGB signals of every 
+ * VESA mode, for the given duration but at least two frames. The first 
+ * frame only synchronises the capture. The captured
+ * frame is compared with the generated one, and the number of frames per
+ * second and the ratio to real time on a single core are printed. The 
+ * duration in milliseconds per mode is the first argument.
+ * 
+ * The SV monitor can't be benchmarked without a design, compare it with the
+ * speed of a board built with and without NATIVE_VGA=1.
+ * 
+ * Build and run with "make capture" in this directory, the Verilator headers
+ * are needed for the checkpoint functions of cVgaCapture.
+ */
+
+using namespace RoaLogic::vdb;
+
+namespace
+{
+    const size_t cMaxPixels = 1024 * 768;   //!< Frame buffer size, the same as the VGA monitor
+
+    bool check(bool condition, const std::string& message)
+    {
+        if(!condition)
+        {
+            std::cout << "FAIL: " << message << "\n";
+        }
+
+        return condition;
+    }
+
+    /**
+     * @brief The colour of a pixel, only 4 bits per colour like the DE10-Lite
+     */
+    uint32_t colour(uint32_t x, uint32_t y)
+    {
+        return ((x & 0xf) << 20) | ((y & 0xf) << 12) | (((x ^ y) & 0xf) << 4);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::chrono::milliseconds duration(argc > 1 ? std::strtoul(argv[1], nullptr, 0) : 250);
+
+    cVgaCapture capture(cMaxPixels);
+    bool ok = true;
+
+    for(const sVesaTiming& timing : cVesaTiming)
+    {
+        const uint32_t hBlank = timing.syncHorizontal + timing.backPorchHorizontal;
+        const uint32_t vBlank = timing.syncVertical + timing.backPorchVertical;
+        const std::string mode = std::to_string(timing.horizontalPixels) + "x" + std::to_string(timing.verticalPixels) + 
+                                 "@" + std::to_string(timing.frequencyHz) + "Hz";
+        auto start = std::chrono::steady_clock::now();
+        auto now = start;
+        uint32_t frames = 0;
+        bool match = true;
+
+        capture.setHorizontalTiming({timing.horizontalPixels, timing.frontPorchHorizontal,
+                                     timing.syncHorizontal, timing.backPorchHorizontal});
+        capture.setVerticalTiming({timing.verticalPixels, timing.frontPorchVertical,
+                                   timing.syncVertical, timing.backPorchVertical});
+
+        // Each line and frame starts with the sync pulse, followed by the back porch
+        do
+        {
+            for(uint32_t y = 0; y < timing.totalVertical; y++)
+            {
+                const bool vsync = y >= timing.syncVertical;
+
+                for(uint32_t x = 0; x < timing.totalHorizontal; x++)
+                {
+                    const uint32_t rgb = colour(x, y);
+
+                    capture.clock(rgb >> 16, rgb >> 8, rgb, x >= timing.syncHorizontal, vsync);
+                }
+            }
+
+            frames++;
+            now = std::chrono::steady_clock::now();
+        } while(frames < 2 || now - start < duration);
+
+        // Active video starts one pixel after the back porch, the same as the verilog module
+        for(uint32_t y = 0; y < timing.verticalPixels && match; y++)
+        {
+            for(uint32_t x = 0; x < timing.horizontalPixels && match; x++)
+            {
+                match = capture.data()[y * timing.horizontalPixels + x] == colour(x + hBlank + 1, y + vBlank);
+            }
+        }
+
+        const double framesPerSecond = frames / std::chrono::duration<double>(now - start).count();
+
+        std::cout << mode << ": " << static_cast<uint32_t>(framesPerSecond) << " frames/s, " 
+                  << framesPerSecond / timing.frequencyHz << "x real time\n";
+
+        ok &= check(match, "captured frame of " + mode + " doesn't match the generated frame");
+    }
+
+    std::cout << (ok ? "PASS" : "FAILED") << "\n";
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,251 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    VGA pixel conversion test and benchmark                      //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "vgaPixelConverter.hpp"
+#include "vesaTiming.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file vgaPixelConverterTest.cpp
+ * @brief Test and benchmark of the VGA pixel conversion
+ * @version 0.1
+ * @date 16-oct-2026
+ * 
+ * @details Every implementation of cVgaPixelConverter supported by the CPU
+ * is compared with the scalar one. The test checks that:
+ * - the RGB data is the same for 0 up to cMaxPixels pixels, so every tail 
+ *   length of the vector loops is covered.
+ * - the result doesn't depend on the alignment of the source and destination.
+ * - no byte after the converted pixels is written.
+ * - convert() uses one of the supported implementations.
+ * 
+ * Afterwards each implementation converts frames of every VESA mode for the
+ * given duration, and the number of frames per second on a single core is 
+ * printed. The duration in milliseconds per mode is the first argument, 0 
+ * skips the benchmark.
+ * 
+ * Build and run with "make" in this directory.
+ */
+
+using namespace RoaLogic::vdb;
+
+namespace
+{
+    const size_t cMaxPixels = 300;          //!< Pixel counts 0 up to cMaxPixels-1 are checked
+    const size_t cMaxSourceOffset = 4;      //!< Source offsets in pixels
+    const size_t cMaxDestinationOffset = 4; //!< Destination offsets in bytes
+    const size_t cGuardBytes = 64;          //!< Bytes after the destination that shall not change
+    const uint8_t cGuard = 0xa5;            //!< Value of the guard bytes
+
+    bool check(bool condition, const std::string& message)
+    {
+        if(!condition)
+        {
+            std::cout << "FAIL: " << message << "\n";
+        }
+
+        return condition;
+    }
+
+    /**
+     * @brief Compare an implementation with the scalar conversion
+     * 
+     * @return true when all pixel counts and alignments give the same result
+     */
+    bool compare(const cVgaPixelConverter::sImplementation& scalar, 
+                 const cVgaPixelConverter::sImplementation& implementation,
+                 const std::vector<uRGBValue>& pixels)
+    {
+        const size_t cBufferSize = 3 * cMaxPixels + cMaxDestinationOffset + cGuardBytes;
+        std::vector<uint8_t> expected(cBufferSize);
+        std::vector<uint8_t> result(cBufferSize);
+
+        for(size_t sourceOffset = 0; sourceOffset < cMaxSourceOffset; sourceOffset++)
+        {
+            for(size_t destinationOffset = 0; destinationOffset < cMaxDestinationOffset; destinationOffset++)
+            {
+                for(size_t numPixels = 0; numPixels < cMaxPixels; numPixels++)
+                {
+                    const size_t numBytes = 3 * numPixels;
+                    const uRGBValue* source = pixels.data() + sourceOffset;
+
+                    std::memset(expected.data(), cGuard, expected.size());
+                    std::memset(result.data(), cGuard, result.size());
+
+                    scalar.convert(source, expected.data() + destinationOffset, numPixels);
+                    implementation.convert(source, result.data() + destinationOffset, numPixels);
+
+                    if(expected != result)
+                    {
+                        const std::string where = std::string(implementation.name) + " with " + 
+                                                  std::to_string(numPixels) + " pixels, source offset " +
+                                                  std::to_string(sourceOffset) + ", destination offset " + 
+                                                  std::to_string(destinationOffset);
+
+                        // Tell a wrong conversion apart from a write after the last pixel
+                        if(std::memcmp(expected.data(), result.data(), destinationOffset + numBytes) != 0)
+                        {
+                            return check(false, "wrong RGB data of " + where);
+                        }
+
+                        return check(false, "bytes after the last pixel written by " + where);
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Benchmark the implementations for every VESA mode
+     */
+    void benchmark(const cVgaPixelConverter::sImplementation* implementations, size_t numImplementations,
+                   std::chrono::milliseconds duration)
+    {
+        std::vector<uRGBValue> frame(1024 * 768);
+        std::vector<uint8_t> rgb(frame.size() * 3);
+
+        for(size_t i = 0; i < frame.size(); i++)
+        {
+            frame[i].asInt = static_cast<uint32_t>(i * 2654435761u);
+        }
+
+        for(const sVesaTiming& timing : cVesaTiming)
+        {
+            const size_t numPixels = static_cast<size_t>(timing.horizontalPixels) * timing.verticalPixels;
+
+            for(size_t i = 0; i < numImplementations; i++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                auto now = start;
+                uint32_t frames = 0;
+
+                do
+                {
+                    implementations[i].convert(frame.data(), rgb.data(), numPixels);
+                    frames++;
+                    now = std::chrono::steady_clock::now();
+                } while(now - start < duration);
+
+                std::cout << timing.horizontalPixels << "x" << timing.verticalPixels << "@" 
+                          << timing.frequencyHz << "Hz " << implementations[i].name << ": "
+                          << static_cast<uint32_t>(frames / std::chrono::duration<double>(now - start).count())
+                          << " frames/s\n";
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::chrono::milliseconds duration(argc > 1 ? std::strtoul(argv[1], nullptr, 0) : 250);
+
+    cVgaPixelConverter::sImplementation implementations[4];
+    size_t numImplementations = cVgaPixelConverter::getImplementations(implementations, 4);
+    std::vector<uRGBValue> pixels(cMaxPixels + cMaxSourceOffset);
+    bool selectedFound = false;
+    bool ok = true;
+
+    // Random colours and alpha, the alpha shall never end up in the RGB data
+    uint32_t seed = 1;
+
+    for(uRGBValue& pixel : pixels)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        pixel.asInt = seed;
+    }
+
+    ok &= check(numImplementations > 0 && std::string(implementations[0].name) == "scalar", 
+                "the scalar implementation is not the first one");
+
+    std::cout << "Implementations:";
+
+    for(size_t i = 0; i < numImplementations; i++)
+    {
+        std::cout << " " << implementations[i].name;
+        selectedFound |= std::string(implementations[i].name) == cVgaPixelConverter::getName();
+    }
+
+    std::cout << ", selected: " << cVgaPixelConverter::getName() << "\n";
+
+    ok &= check(selectedFound, "convert() uses an implementation which is not supported");
+
+    for(size_t i = 0; i < numImplementations && ok; i++)
+    {
+        ok &= compare(implementations[0], implementations[i], pixels);
+    }
+
+    // The scalar conversion itself, against the definition of uRGBValue
+    if(ok)
+    {
+        std::vector<uint8_t> rgb(3 * cMaxPixels);
+        implementations[0].convert(pixels.data(), rgb.data(), cMaxPixels);
+
+        for(size_t i = 0; i < cMaxPixels && ok; i++)
+        {
+            ok &= check(rgb[3 * i + 0] == ((pixels[i].asInt >> 16) & 0xff) &&
+                        rgb[3 * i + 1] == ((pixels[i].asInt >> 8) & 0xff) &&
+                        rgb[3 * i + 2] == (pixels[i].asInt & 0xff), 
+                        "scalar conversion of pixel " + std::to_string(i));
+        }
+    }
+
+    std::cout << (ok ? "PASS" : "FAILED") << "\n";
+
+    if(ok && duration.count() > 0)
+    {
+        benchmark(implementations, numImplementations, duration);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
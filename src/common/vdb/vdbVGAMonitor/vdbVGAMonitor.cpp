@@ -48,6 +48,7 @@
 //#define DBG_VDB_VGA
 
 using namespace RoaLogic::vdb;
+using namespace RoaLogic::testbench::clock::units;
 //#define DBG_MEASURE_VDB_VGA
 
 #ifdef DBG_MEASURE_VDB_VGA
@@ -90,7 +91,7 @@ static const sVGATiming cVGATiming[] =
     { 640, 480, 85, 36.000_MHz,  832, 32,  48, 112, 509,  1, 3, 25},
     { 800, 600, 56, 38.100_MHz, 1088, 32, 128, 128, 619,  1, 4, 14},
     { 800, 600, 60, 40.000_MHz, 1056, 40, 128,  88, 628,  1, 4, 23},
-    { 800, 600, 72, 50.000_MHz,  932, 56, 120,  64, 666, 37, 6, 23},
+    { 800, 600, 72, 50.000_MHz, 1040, 56, 120,  64, 666, 37, 6, 23},
     { 800, 600, 75, 49.500_MHz, 1056, 16,  80, 160, 624,  1, 2, 21},
     { 800, 600, 85, 56.250_MHz, 1048, 32,  64, 152, 632,  1, 3, 27},
     {1024, 768, 60, 65.000_MHz, 1344, 24, 136, 160, 806,  3, 6, 29},
@@ -116,8 +117,8 @@ void vdbVGAMonitorVSYNC(int id)
     #ifdef DBG_MEASURE_VDB_VGA
     auto start =steady_clock::now();
     #endif
-    // Get the scope of the current call and pass this into the processing function
-    cVDBCommon::processVerilatorEvent(svGetScope(), 1);
+    // Get the scope of the current call and pass the VSYNC to the monitor of this scope
+    cVdbVGAMonitor::dispatch<&cVdbVGAMonitor::onVSync>(svGetScope());
 
     #ifdef DBG_MEASURE_VDB_VGA
     auto stop = steady_clock::now();
@@ -143,13 +144,21 @@ namespace vdb
      * @param[in] scopeName     The scope of this class
      * @param[in] timeInterface Pointer to the timing interface
      * @param[in] pixelClock    Pointer to the pixelClock for generating the VGA pixel clock
+     * @param[in] framebuffer   The frame buffer of the verilated instance, not used with VDB_NATIVE_VGA
      */
-    cVdbVGAMonitor::cVdbVGAMonitor(std::string scopeName, cTimeInterface* timeInterface, cClock* pixelClock,
+#ifdef VDB_NATIVE_VGA
+    cVdbVGAMonitor::cVdbVGAMonitor(std::string scopeName, cTimeInterface* timeInterface, cEdgeClock* pixelClock) :
+        cVDBComponent(scopeName, 0),
+        _timeInterface(timeInterface),
+        _pixelClock(pixelClock)
+#else
+    cVdbVGAMonitor::cVdbVGAMonitor(std::string scopeName, cTimeInterface* timeInterface, cEdgeClock* pixelClock,
                 VlUnpacked<unsigned int,cMaxVerticalLines*cMaxHorizontalLines>& framebuffer) :
-        cVDBCommon(scopeName, 0),
+        cVDBComponent(scopeName, 0),
         _timeInterface(timeInterface),
         _pixelClock(pixelClock),
         _myFramebuffer(framebuffer)
+#endif
     {
         // Make sure that the passed parameters are not nullpointers
         assert(timeInterface != nullptr);   
@@ -157,6 +166,7 @@ namespace vdb
 
         _myEventData.horizontalLines = 0;
         _myEventData.verticalLines = 0;
+        _myEventData.frameRate = 0;
 
         #ifdef DBG_MEASURE_VDB_VGA
         _previousVsync = std::chrono::steady_clock::now();
@@ -191,74 +201,252 @@ namespace vdb
      * event, so that the user knows that it's the last line of data. It is up to the user on how
      * to handle the data of this event. 
      * 
+     * While the notifications are suspended, or nobody observes the vgaDataReady event, the
+     * capture is stopped by disabling the pixel clock and the framebuffer writes. Only the 
+     * VSYNC time is tracked, so that the resolution is found again on the first VSYNC after
+     * the capture is needed again.
+     * 
      * @note The passed data is a pointer that is continously updated, make sure that the
      * data abstraction is thread safe.
      */
-    void cVdbVGAMonitor::verilatorCallback(uint32_t event)
+    void cVdbVGAMonitor::onVSync()
     {
         simtime_t currentVSyncTime = _timeInterface->getTime();
         simtime_t timeBetweenVsync = currentVSyncTime - _previousVSyncTime;
         _previousVSyncTime = currentVSyncTime;
 
+        setCapture(!notificationsSuspended() && hasObservers(eEvent::vgaDataReady));
+
+        if(!_capturing)
+        {
+            _currentSetting = 0xFF;
+            stopSampling();
+            return;
+        }
+
         #ifdef DBG_VDB_VGA
         INFO << "VGA: Frequency " << timeBetweenVsync.Hz() << "Hz \n";
         INFO << "VGA: Num hsync in vsync:"<< vdbVGAMonitorGetLineCnt() << "\n";
         #endif
 
+        const double frequencyHz = std::round(timeBetweenVsync.Hz());
+        const svBitVecVal lineCount = vdbVGAMonitorGetLineCnt();
+        size_t setting = 0;
+
         // Loop through the lookup table 
-        for (size_t i = 0; i < cVGATimingSize; i++)
+        while(setting < cVGATimingSize && 
+              !(cVGATiming[setting].frequencyHz == frequencyHz && cVGATiming[setting].totalVertical == lineCount))
+        {
+            setting++;
+        }
+
+        // Only stop when no element of the table matches
+        if(setting == cVGATimingSize)
+        {
+            _currentSetting = 0xFF;
+            stopSampling();
+            return;
+        }
+
+        // _currentSetting is used to see if we already found an element
+        if(_currentSetting != setting)
+        {
+            // New resolution found
+            #ifdef DBG_VDB_VGA
+            INFO << "VGA: Found resolution: "<< cVGATiming[setting].horizontalPixels << "*"<< cVGATiming[setting].verticalPixels << "\n";
+            #endif
+            _currentSetting = setting;
+
+            programTiming(setting);
+
+            // Start the pixel clock, or the capture on the design clock
+            long double pixelClock = cVGATiming[setting].totalHorizontal * cVGATiming[setting].totalVertical * timeBetweenVsync.Hz();
+            startSampling(setting, pixelClock);
+
+            // Set the horizontal and vertical pixels
+            _myEventData.horizontalLines = cVGATiming[_currentSetting].horizontalPixels;
+            _myEventData.verticalLines = cVGATiming[_currentSetting].verticalPixels;
+            _myEventData.frameRate = cVGATiming[_currentSetting].frequencyHz;
+        }
+
+        // Set the data in the event, number of vertical and horizontal pixels is already set
+#ifdef VDB_NATIVE_VGA
+        _myEventData.dataArray = reinterpret_cast<uRGBValue*>(const_cast<uint32_t*>(_capture.data()));
+#else
+        _myEventData.dataArray = reinterpret_cast<uRGBValue*>(_myFramebuffer.data());
+#endif
+        notifyObserver(eEvent::vgaDataReady, &_myEventData);
+    }
+
+    /**
+     * @brief Program the timing of a lookup table setting
+     * @details The timing is sent to the verilated instance through the 
+     * exported DPI functions, or to the capture engine with VDB_NATIVE_VGA.
+     * 
+     * @param[in] setting   Offset in the VGA timing lookup table
+     */
+    void cVdbVGAMonitor::programTiming(size_t setting)
+    {
+        const sVGATiming& timing = cVGATiming[setting];
+
+#ifdef VDB_NATIVE_VGA
+        _capture.setHorizontalTiming({timing.horizontalPixels, timing.frontPorchHorizontal,
+                                      timing.syncHorizontal, timing.backPorchHorizontal});
+        _capture.setVerticalTiming({timing.verticalPixels, timing.frontPorchVertical,
+                                    timing.syncVertical, timing.backPorchVertical});
+#else
+        // Set the scope and sent the values through the DPI functions
+        svSetScope(_myScope);
+
+        vdbVGAMonitorSetHorizontalTiming(&timing.horizontalPixels,
+                                         &timing.frontPorchHorizontal,
+                                         &timing.syncHorizontal,
+                                         &timing.backPorchHorizontal);
+        vdbVGAMonitorSetVerticalTiming(&timing.verticalPixels,
+                                       &timing.frontPorchVertical,
+                                       &timing.syncVertical,
+                                       &timing.backPorchVertical);
+#endif
+    }
+
+    /**
+     * @brief Start sampling the pixels of a lookup table setting
+     * @details Sets the period of the pixel clock and enables it. With 
+     * VDB_NATIVE_VGA and sampleOnDesignClock() the pixels are captured on 
+     * the design clock instead. When no divider is set, it is detected from
+     * the measured design clock cycles per line, which must be a multiple 
+     * of the horizontal total. Otherwise the pixel clock is used.
+     * 
+     * @param[in] setting       Offset in the VGA timing lookup table
+     * @param[in] pixelClock    The measured pixel clock frequency in Hz
+     */
+    void cVdbVGAMonitor::startSampling(size_t setting, long double pixelClock)
+    {
+#ifdef VDB_NATIVE_VGA
+        _activeDivider = 0;
+
+        if(_onDesignClock)
         {
-            // Check if we have found the right element in the table
-            if(cVGATiming[i].frequencyHz == std::round(timeBetweenVsync.Hz()) &&
-                cVGATiming[i].totalVertical == vdbVGAMonitorGetLineCnt())
+            const uint32_t total = cVGATiming[setting].totalHorizontal;
+            uint32_t divider = _divider;
+
+            if(divider == 0 && _measuredLineCycles != 0 && _measuredLineCycles % total == 0)
             {
-                // _currentSetting is used to see if we already found an element
-                if(_currentSetting != i)
-                {
-                    // New resolution found
-                    #ifdef DBG_VDB_VGA
-                    INFO << "VGA: Found resolution: "<< cVGATiming[i].horizontalPixels << "*"<< cVGATiming[i].verticalPixels << "\n";
-                    #endif
-                    _currentSetting = i;
-
-                    // Set the scope and sent the values through the DPI functions
-                    svSetScope(_myScope);
-
-                    //Program VGAMonitor model
-		            vdbVGAMonitorSetHorizontalTiming(&cVGATiming[i].horizontalPixels,
-                                                     &cVGATiming[i].frontPorchHorizontal,
-                                                     &cVGATiming[i].syncHorizontal,
-                                                     &cVGATiming[i].backPorchHorizontal);
-                    vdbVGAMonitorSetVerticalTiming(&cVGATiming[i].verticalPixels,
-                                                   &cVGATiming[i].frontPorchVertical,
-                                                   &cVGATiming[i].syncVertical,
-                                                   &cVGATiming[i].backPorchVertical);
-
-                    // Set the pixel clock timing
-                    long double pixelClock = cVGATiming[i].totalHorizontal * cVGATiming[i].totalVertical * timeBetweenVsync.Hz();
-                    _pixelClock->setLowPeriod ( (1.0/pixelClock)/2.0 );
-                    _pixelClock->setHighPeriod( (1.0/pixelClock)/2.0 );
-
-                    // Enable pixel clock
-                    _pixelClock->enable();
-
-                    // Set the horizontal and vertical pixels
-                    _myEventData.horizontalLines = cVGATiming[_currentSetting].horizontalPixels;
-                    _myEventData.verticalLines = cVGATiming[_currentSetting].verticalPixels;
-                }
-
-                // Set the data in the event, number of vertical and horizontal pixels is already set
-                _myEventData.dataArray = reinterpret_cast<uRGBValue*>(_myFramebuffer.data());
-                notifyObserver(eEvent::vgaDataReady, &_myEventData);
-
-                break;
+                divider = _measuredLineCycles / total;
             }
-            else
+
+            if(divider != 0)
             {
-                _currentSetting = 0xFF;
+                INFO << "VGA: Pixels captured every " << divider << " design clock cycles\n";
+
+                _activeDivider = divider;
+                _dividerCount = 0;
                 _pixelClock->disable();
+                return;
             }
+
+            WARNING << "VGA: " << _measuredLineCycles << " design clock cycles per line isn't a multiple of " 
+                    << total << " pixels, the pixel clock is used\n";
         }
+#else
+        (void)setting;
+#endif
+
+        _pixelClock->setLowPeriod ( (1.0/pixelClock)/2.0 );
+        _pixelClock->setHighPeriod( (1.0/pixelClock)/2.0 );
+        _pixelClock->enable();
+    }
+
+    /**
+     * @brief Stop sampling the pixels
+     * @details Disables the pixel clock and the capture on the design clock
+     */
+    void cVdbVGAMonitor::stopSampling()
+    {
+        _pixelClock->disable();
+
+#ifdef VDB_NATIVE_VGA
+        _activeDivider = 0;
+#endif
+    }
+
+#ifdef VDB_NATIVE_VGA
+    /**
+     * @brief Capture the pixels on a design clock
+     * @details Instead of a separate pixel clock, the pixels are captured
+     * on every divider-th rising edge of a clock of the design, see 
+     * designClock(). This only works when the design generates the VGA 
+     * timing from that clock. Takes effect from the next detected resolution.
+     * 
+     * @param[in] divider   Design clock cycles per pixel, 0 detects the 
+     *                      divider from the horizontal timing
+     */
+    void cVdbVGAMonitor::sampleOnDesignClock(uint32_t divider)
+    {
+        _onDesignClock = true;
+        _divider = divider;
+        _currentSetting = 0xFF;
+    }
+#endif
+
+    /**
+     * @brief Turn the framebuffer writes of the verilated instance on or off
+     * @details The exported DPI function is only called when the state changes,
+     * with VDB_NATIVE_VGA the writes of the capture engine are turned on or off.
+     * 
+     * @param[in] capture   The frame is captured
+     */
+    void cVdbVGAMonitor::setCapture(bool capture)
+    {
+        if(capture != _capturing)
+        {
+            #ifdef DBG_VDB_VGA
+            INFO << "VGA: Capture " << (capture ? "on" : "off") << "\n";
+            #endif
+
+#ifdef VDB_NATIVE_VGA
+            _capture.setCapture(capture);
+#else
+            svSetScope(_myScope);
+            vdbVGAMonitorSetCapture(capture);
+#endif
+            _capturing = capture;
+        }
+    }
+
+    /**
+     * @brief Save the VGA state into a checkpoint
+     * @details Saves the detected resolution and the time of the previous
+     * VSYNC, the pixel clock is saved with the edge scheduler. With
+     * VDB_NATIVE_VGA the state of the capture engine is saved as well.
+     */
+    void cVdbVGAMonitor::saveState(VerilatedSerialize& os)
+    {
+        double previousVSyncUs = _previousVSyncTime.ms() * 1000.0;
+
+        os << _currentSetting << _myEventData.horizontalLines << _myEventData.verticalLines << previousVSyncUs << _capturing;
+
+#ifdef VDB_NATIVE_VGA
+        _capture.saveState(os);
+        os << _activeDivider << _dividerCount << _lineCycles << _measuredLineCycles << _hsyncDelayed;
+#endif
+    }
+
+    /**
+     * @brief Restore the VGA state from a checkpoint
+     */
+    void cVdbVGAMonitor::restoreState(VerilatedDeserialize& os)
+    {
+        double previousVSyncUs = 0;
+
+        os >> _currentSetting >> _myEventData.horizontalLines >> _myEventData.verticalLines >> previousVSyncUs >> _capturing;
+        _previousVSyncTime = simtime_t(previousVSyncUs * 1.0_us);
+        _myEventData.frameRate = _currentSetting < cVGATimingSize ? cVGATiming[_currentSetting].frequencyHz : 0;
+
+#ifdef VDB_NATIVE_VGA
+        _capture.restoreState(os);
+        os >> _activeDivider >> _dividerCount >> _lineCycles >> _measuredLineCycles >> _hsyncDelayed;
+#endif
     }
 
 }}
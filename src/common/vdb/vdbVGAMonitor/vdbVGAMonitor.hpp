@@ -50,7 +50,11 @@
  */
 
 
-#include "vdbCommon.hpp"
+#include "vdbComponent.hpp"
+#include "edgeScheduler.hpp"
+#include "vgaCapture.hpp"
+#include "vgaPixelConverter.hpp"
+#include <algorithm>
 #include <vector>
 
 #ifndef VDB_VGA_HPP
@@ -58,30 +62,45 @@
 
 using namespace RoaLogic::testbench;
 using namespace RoaLogic::observer;
+using namespace RoaLogic::scheduler;
 
 namespace RoaLogic
 {
 namespace vdb
 {
-    union uRGBValue
-    {
-        uint32_t asInt;
-        struct
-        {
-            uint8_t blue;
-            uint8_t green;
-            uint8_t red;
-            uint8_t alpha;
-        };
-    };
-
     struct sVgaData
     {
         uint32_t horizontalLines;
         uint32_t verticalLines;
+        uint32_t frameRate;         //!< Frame rate in Hz of the detected VESA mode
         uRGBValue* dataArray;    
     };
 
+    /**
+     * @brief Copy of a VGA frame, owned by the receiver of the vgaDataReady event
+     */
+    struct sVgaFrame
+    {
+        uint32_t width = 0;                 //!< Number of pixels per line
+        uint32_t height = 0;                //!< Number of lines
+        uint32_t frameRate = 0;             //!< Frame rate in Hz
+        std::vector<uRGBValue> pixels;      //!< The pixels, all lines appended after each other
+
+        /**
+         * @brief Copy the frame of a vgaDataReady event
+         * @details The pixel vector only grows, so no memory is allocated
+         * as long as the resolution doesn't increase.
+         */
+        void copy(const sVgaData& data)
+        {
+            width = data.horizontalLines;
+            height = data.verticalLines;
+            frameRate = data.frameRate;
+            pixels.resize(static_cast<size_t>(width) * height);
+            std::copy_n(data.dataArray, pixels.size(), pixels.data());
+        }
+    };
+
     /**
      * @class cVdbVGAMonitor
      * @author Bjorn Schouteten
@@ -98,31 +117,114 @@ namespace vdb
      * array with a size of horizontal lines * vertical lines. All the horizontal
      * lines are appended after each other.
      * 
+     * The VSYNC is dispatched by scope, since the handler programs the 
+     * verilated instance through exported DPI functions.
+     * 
+     * The frame is only captured when an observer is registered for the 
+     * vgaDataReady event, e.g. a visible VGA window, and the notifications
+     * aren't suspended. Otherwise the pixel clock is disabled and the 
+     * framebuffer writes of the verilated instance are turned off, so an 
+     * unused monitor costs one DPI call per VSYNC.
+     * 
+     * With VDB_NATIVE_VGA the verilated instance has no pixel clock and no 
+     * frame buffer. The testbench samples the VGA outputs on every rising 
+     * edge of the pixel clock and passes them to clock(), the frames are 
+     * captured by a cVgaCapture. The pixel clock then only exists in the 
+     * edge scheduler.
+     * 
+     * When the design generates the VGA timing from one of its own clocks,
+     * the pixel clock can be left out completely, see sampleOnDesignClock().
+     * The testbench then calls designClock() on every rising edge of that 
+     * clock, and every divider-th edge captures a pixel. The divider is set,
+     * or detected from the number of design clock cycles per line.
+     * 
      */
-    class cVdbVGAMonitor : public cVDBCommon
+    class cVdbVGAMonitor : public cVDBComponent<cVdbVGAMonitor, sVgaData>
     {
+        friend void ::vdbVGAMonitorVSYNC(int id);
+
         public:
         static const size_t cMaxHorizontalLines = 1024;
         static const size_t cMaxVerticalLines = 768;
 
         private:
         cTimeInterface* _timeInterface;   //!< Pointer to the time interface for retrieving the current time
-        cClock* _pixelClock;              //!< Pointer to the pixel clock, which must be generated within this class
+        cEdgeClock* _pixelClock;          //!< Pointer to the pixel clock, which must be generated within this class
         simtime_t _previousVSyncTime;     //!< Previous time that a VSYNC occured
         uint8_t _currentSetting = 0xff;   //!< Current lookup table setting, 0xff means no element found
+        bool _capturing = true;           //!< The framebuffer writes of the verilated instance are enabled
         sVgaData _myEventData;            //!< Event data element which is passed in any of the events
 
+#ifdef VDB_NATIVE_VGA
+        cVgaCapture _capture{cMaxVerticalLines*cMaxHorizontalLines};  //!< Captures the frames in C++
+        bool _onDesignClock = false;      //!< Pixels are captured on a design clock instead of the pixel clock
+        uint32_t _divider = 0;            //!< Configured design clock divider, 0 means detect
+        uint32_t _activeDivider = 0;      //!< Divider in use, 0 when no pixels are captured on the design clock
+        uint32_t _dividerCount = 0;       //!< Design clock cycles since the last captured pixel
+        uint32_t _lineCycles = 0;         //!< Design clock cycles since the last HSYNC
+        uint32_t _measuredLineCycles = 0; //!< Design clock cycles between the last two HSYNCs
+        bool _hsyncDelayed = false;       //!< HSYNC at the previous design clock edge
+#else
         //!< The VGA data array buffer allocated in the verilog code, used as reference to show the data on screen
         VlUnpacked<unsigned int, cMaxVerticalLines*cMaxHorizontalLines>& _myFramebuffer;
+#endif
 
-        // Function to call for going from static scope to class scope
-        void verilatorCallback(uint32_t event);
+        void onVSync();
+        void setCapture(bool capture);
+        void programTiming(size_t setting);
+        void startSampling(size_t setting, long double pixelClock);
+        void stopSampling();
 
         public:
-        cVdbVGAMonitor(std::string scopeName, cTimeInterface* timeInterface, cClock* pixelClock,
+#ifdef VDB_NATIVE_VGA
+        cVdbVGAMonitor(std::string scopeName, cTimeInterface* timeInterface, cEdgeClock* pixelClock);
+
+        /**
+         * @brief Capture a pixel
+         * @details Shall be called on every rising edge of the pixel clock, 
+         * with the VGA outputs of the design just before the edge.
+         */
+        void clock(uint8_t red, uint8_t green, uint8_t blue, bool hsync, bool vsync)
+        {
+            _capture.clock(red, green, blue, hsync, vsync);
+        }
+
+        /**
+         * @brief Handle a rising edge of the design clock
+         * @details Shall be called on every rising edge of the clock set with
+         * sampleOnDesignClock(), with the VGA outputs just before the edge. 
+         * Measures the number of cycles per line, and captures a pixel every
+         * divider-th edge.
+         */
+        void designClock(uint8_t red, uint8_t green, uint8_t blue, bool hsync, bool vsync)
+        {
+            _lineCycles++;
+
+            if(!hsync && _hsyncDelayed)
+            {
+                _measuredLineCycles = _lineCycles;
+                _lineCycles = 0;
+            }
+
+            _hsyncDelayed = hsync;
+
+            if(_activeDivider != 0 && ++_dividerCount >= _activeDivider)
+            {
+                _dividerCount = 0;
+                _capture.clock(red, green, blue, hsync, vsync);
+            }
+        }
+
+        void sampleOnDesignClock(uint32_t divider);
+#else
+        cVdbVGAMonitor(std::string scopeName, cTimeInterface* timeInterface, cEdgeClock* pixelClock,
                 VlUnpacked<unsigned int, cMaxVerticalLines*cMaxHorizontalLines>& framebuffer);
+#endif
 
         ~cVdbVGAMonitor();
+
+        void saveState(VerilatedSerialize& os);
+        void restoreState(VerilatedDeserialize& os);
     };
 
 }
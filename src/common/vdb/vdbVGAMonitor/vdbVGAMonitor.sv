@@ -65,6 +65,11 @@
  * | 1024x768,70Hz | 75.000 |  1024  |  24   | 136  | 144   |  768   |   1   |  6   |  29   |
  * | 1024x768,75Hz | 78.750 |  1024  |  16   |  96  | 176   |  768   |   1   |  3   |  28   |
  * | 1024x768,85Hz | 94.500 |  1024  |  48   |  96  | 208   |  768   |   1   |  3   |  36   |
+ *
+ * With VDB_NATIVE_VGA the pixel clock domain and the frame buffer are not part
+ * of this module. The testbench samples r, g, b, hsync and vsync itself and
+ * the C++ capture engine does the porch and sync accounting, see cVgaCapture.
+ * This module then only counts the lines and calls the VSYNC callback.
  */
 
 module vdbVGAMonitor
@@ -115,6 +120,7 @@ module vdbVGAMonitor
   //import "DPI-C" context function void vdbVGAMonitorHSYNC(int ID);
   import "DPI-C" context function void vdbVGAMonitorVSYNC(int ID);
 
+`ifndef VDB_NATIVE_VGA
   export "DPI-C" task vdbVGAMonitorSetHorizontalTiming;
   task vdbVGAMonitorSetHorizontalTiming (input bit [10:0] pixels, input bit [7:0] fp, input bit [7:0] sync, input bit [7:0] bp);
       vertical.active        = pixels;
@@ -131,10 +137,16 @@ module vdbVGAMonitor
       vertical.back_porch  = bp;
   endtask
 
+  export "DPI-C" function vdbVGAMonitorSetCapture;
+  function void vdbVGAMonitorSetCapture(input bit enable);
+      capture_enable = enable;
+  endfunction
+
   export "DPI-C" function vdbVGAMonitorGetPixel;
   function rgb_t vdbVGAMonitorGetPixel(input int line, input int pixel);
     return framebuffer[line][pixel];
   endfunction
+`endif
 
   export "DPI-C" function vdbVGAMonitorGetLineCnt;
   function int vdbVGAMonitorGetLineCnt;
@@ -154,6 +166,9 @@ module vdbVGAMonitor
   //-----------------------
   // Variables
   //
+  logic [LINES_LEN -1:0] line_cnt, stored_line_cnt;
+
+`ifndef VDB_NATIVE_VGA
   wire                   pixel_clk /*verilator public*/;
 
   logic                  hsync_dly, vsync_dly;
@@ -171,9 +186,10 @@ module vdbVGAMonitor
 
   logic                  active_video;
   logic [PIXELS_LEN-1:0] pixel_cnt;
-  logic [LINES_LEN -1:0] line_cnt, stored_line_cnt;
 
   rgb_t                  framebuffer [TOTAL_PIXELS] /*verilator public*/;
+  bit                    capture_enable = 1'b1;
+`endif
 
 
   //-----------------------
@@ -181,6 +197,7 @@ module vdbVGAMonitor
   //
   initial
   begin
+`ifndef VDB_NATIVE_VGA
       horizontal.active      = HOR_ACT;
       horizontal.front_porch = HOR_FP;
       horizontal.sync        = HOR_SYNC;
@@ -190,6 +207,7 @@ module vdbVGAMonitor
       vertical.front_porch   = VERT_FP;
       vertical.sync          = VERT_SYNC;
       vertical.back_porch    = VERT_BP;
+`endif
 
       line_cnt               = 0;
   end
@@ -200,6 +218,19 @@ module vdbVGAMonitor
   always @(negedge vsync) vdbVGAMonitorVSYNC(ID);
 
 
+  /**
+     Line Count
+     Don't use pixel_clk, because pixel_clk might not be available yet
+  */
+  always @(negedge hsync) line_cnt++;
+  always @(negedge vsync)
+  begin
+      stored_line_cnt = line_cnt;
+      line_cnt        = 0;
+  end
+
+
+`ifndef VDB_NATIVE_VGA
   /**
      HSYNC/VSYNC triggers (end of HSYNC/VSYNC)
   */
@@ -213,18 +244,6 @@ module vdbVGAMonitor
   assign vsync_trigger = ~vsync & vsync_dly;
 
 
-  /**
-     Line Count
-     Don't use pixel_clk, because pixel_clk might not be available yet
-  */
-  always @(negedge hsync) line_cnt++;
-  always @(negedge vsync)
-  begin
-      stored_line_cnt = line_cnt;
-      line_cnt        = 0;
-  end
-
- 
   /**
      Time keeping
   */
@@ -291,7 +310,9 @@ module vdbVGAMonitor
 
   /**
      store RGB value in frame buffer
+     The C++ side turns the capture off when nobody uses the frames
   */
   always @(posedge pixel_clk)
-    if (active_video) framebuffer[pixel_cnt] <= {r,g,b};
+    if (active_video && capture_enable) framebuffer[pixel_cnt] <= {r,g,b};
+`endif
 endmodule
@@ -0,0 +1,153 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Virtual Devboard native VGA capture engine                   //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "vgaCapture.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace RoaLogic
+{
+namespace vdb
+{
+    /**
+     * @brief Free the frame buffer
+     */
+    void cVgaCapture::sFree::operator()(uint32_t* pixels) const
+    {
+        std::free(pixels);
+    }
+
+    /**
+     * @brief Construct a new capture engine
+     * @details Allocates the frame buffer, the size is rounded up to a 
+     * multiple of the alignment. The timing defaults to 640x480.
+     * 
+     * @param[in] maxPixels     Number of pixels of the largest resolution
+     */
+    cVgaCapture::cVgaCapture(size_t maxPixels) :
+        _maxPixels(maxPixels),
+        _horizontal{640, 16, 96, 48},
+        _vertical{480, 11, 2, 31}
+    {
+        size_t size = (maxPixels * sizeof(uint32_t) + cAlignment - 1) / cAlignment * cAlignment;
+
+        _pixels.reset(static_cast<uint32_t*>(std::aligned_alloc(cAlignment, size)));
+
+        if(!_pixels)
+        {
+            throw std::bad_alloc();
+        }
+
+        std::fill_n(_pixels.get(), _maxPixels, 0);
+    }
+
+    /**
+     * @brief Number of clocks between the sync trigger and the active video
+     * @details The trigger is the start of the sync pulse, the counter is 
+     * loaded with sync + back porch - 1, the same as the verilog module.
+     */
+    uint32_t cVgaCapture::blankCount(const sTiming& timing)
+    {
+        uint32_t count = timing.sync + timing.backPorch;
+
+        return count != 0 ? count - 1 : 0;
+    }
+
+    /**
+     * @brief Set the horizontal timing
+     * @details Takes effect from the next HSYNC on
+     * 
+     * @param[in] timing    The horizontal timing in pixels
+     */
+    void cVgaCapture::setHorizontalTiming(const sTiming& timing)
+    {
+        _horizontal = timing;
+    }
+
+    /**
+     * @brief Set the vertical timing
+     * @details Takes effect from the next VSYNC on
+     * 
+     * @param[in] timing    The vertical timing in lines
+     */
+    void cVgaCapture::setVerticalTiming(const sTiming& timing)
+    {
+        _vertical = timing;
+    }
+
+    /**
+     * @brief Save the capture state into a checkpoint
+     * @details The timing and the counters are saved, the frame buffer is 
+     * not. It is filled again by the next frame.
+     */
+    void cVgaCapture::saveState(VerilatedSerialize& os)
+    {
+        uint64_t pixelCount = _pixelCount;
+
+        os << _horizontal.active << _horizontal.frontPorch << _horizontal.sync << _horizontal.backPorch;
+        os << _vertical.active << _vertical.frontPorch << _vertical.sync << _vertical.backPorch;
+        os << _capture << _hsyncDelayed << _vsyncDelayed;
+        os << _hblankCount << _hactiveCount << _vblankCount << _vactiveCount;
+        os << _hactiveVideo << _vactiveVideo << pixelCount;
+    }
+
+    /**
+     * @brief Restore the capture state from a checkpoint
+     */
+    void cVgaCapture::restoreState(VerilatedDeserialize& os)
+    {
+        uint64_t pixelCount = 0;
+
+        os >> _horizontal.active >> _horizontal.frontPorch >> _horizontal.sync >> _horizontal.backPorch;
+        os >> _vertical.active >> _vertical.frontPorch >> _vertical.sync >> _vertical.backPorch;
+        os >> _capture >> _hsyncDelayed >> _vsyncDelayed;
+        os >> _hblankCount >> _hactiveCount >> _vblankCount >> _vactiveCount;
+        os >> _hactiveVideo >> _vactiveVideo >> pixelCount;
+        _pixelCount = pixelCount;
+    }
+}
+}
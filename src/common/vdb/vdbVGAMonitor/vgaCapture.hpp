@@ -0,0 +1,230 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    Virtual Devboard native VGA capture engine header            //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef VGA_CAPTURE_HPP
+#define VGA_CAPTURE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "verilated_save.h"
+
+namespace RoaLogic
+{
+namespace vdb
+{
+    /**
+     * @class cVgaCapture
+     * @brief Native C++ VGA capture engine
+     * @version 0.1
+     * @date 16-oct-2026
+     * 
+     * @details This class does the pixel clock part of the vdbVGAMonitor 
+     * module in C++. The testbench samples the RGB and sync outputs of the 
+     * design on every rising edge of the pixel clock and passes them to 
+     * clock(). The porch and sync accounting is the same as in the verilog 
+     * module, the active pixels are written into a frame buffer owned by 
+     * this class. The verilated model then doesn't hold the frame buffer 
+     * and doesn't have a pixel clock domain.
+     * 
+     * A pixel is stored as 0x00RRGGBB, the same as the rgb_t of the verilog
+     * module. The frame buffer is allocated once for the maximum resolution
+     * and aligned to a cache line.
+     * 
+     * The timing is programmed with setHorizontalTiming() and setVerticalTiming(),
+     * which replace the exported DPI functions of the verilog module.
+     */
+    class cVgaCapture
+    {
+        public:
+        static const size_t cAlignment = 64;   //!< Alignment of the frame buffer in bytes
+
+        /**
+         * @brief Timing of a direction, in pixels or lines
+         */
+        struct sTiming
+        {
+            uint32_t active;        //!< Active video
+            uint32_t frontPorch;    //!< Front porch
+            uint32_t sync;          //!< Sync pulse
+            uint32_t backPorch;     //!< Back porch
+        };
+
+        private:
+        /**
+         * @brief Frees the aligned frame buffer
+         */
+        struct sFree
+        {
+            void operator()(uint32_t* pixels) const;
+        };
+
+        std::unique_ptr<uint32_t[], sFree> _pixels;    //!< The frame buffer
+        size_t _maxPixels;                  //!< Number of pixels in the frame buffer
+
+        sTiming _horizontal;                //!< Horizontal timing in pixels
+        sTiming _vertical;                  //!< Vertical timing in lines
+        bool _capture = true;               //!< Active pixels are written into the frame buffer
+
+        bool _hsyncDelayed = false;         //!< HSYNC at the previous pixel clock
+        bool _vsyncDelayed = false;         //!< VSYNC at the previous pixel clock
+        uint32_t _hblankCount = 0;          //!< Remaining pixels of the sync and back porch
+        uint32_t _hactiveCount = 0;         //!< Remaining active pixels of the line
+        uint32_t _vblankCount = 0;          //!< Remaining lines of the sync and back porch
+        uint32_t _vactiveCount = 0;         //!< Remaining active lines of the frame
+        bool _hactiveVideo = false;         //!< Inside the active pixels of a line
+        bool _vactiveVideo = false;         //!< Inside the active lines of a frame
+        size_t _pixelCount = 0;             //!< Frame buffer offset of the next active pixel
+
+        static uint32_t blankCount(const sTiming& timing);
+
+        public:
+        cVgaCapture(size_t maxPixels);
+
+        void setHorizontalTiming(const sTiming& timing);
+        void setVerticalTiming(const sTiming& timing);
+
+        /**
+         * @brief Turn the frame buffer writes on or off
+         * @details The timing is still tracked while the capture is off
+         */
+        void setCapture(bool capture) { _capture = capture; }
+
+        /**
+         * @brief Get the frame buffer
+         */
+        const uint32_t* data() const { return _pixels.get(); }
+
+        /**
+         * @brief Get the number of pixels of the frame buffer
+         */
+        size_t getMaxPixels() const { return _maxPixels; }
+
+        /**
+         * @brief Process a rising edge of the pixel clock
+         * @details The values are the outputs of the design just before the
+         * edge, the same values the verilog module samples. Called for every 
+         * pixel, so it is kept inline.
+         * 
+         * @param[in] red       Red value
+         * @param[in] green     Green value
+         * @param[in] blue      Blue value
+         * @param[in] hsync     HSYNC, active low
+         * @param[in] vsync     VSYNC, active low
+         */
+        void clock(uint8_t red, uint8_t green, uint8_t blue, bool hsync, bool vsync)
+        {
+            const bool hsyncTrigger = !hsync && _hsyncDelayed;
+            const bool vsyncTrigger = !vsync && _vsyncDelayed;
+
+            // Store the RGB value of an active pixel
+            if(_hactiveVideo && _vactiveVideo)
+            {
+                if(_capture && _pixelCount < _maxPixels)
+                {
+                    _pixels[_pixelCount] = (uint32_t(red) << 16) | (uint32_t(green) << 8) | blue;
+                }
+
+                _pixelCount++;
+            }
+
+            _hsyncDelayed = hsync;
+            _vsyncDelayed = vsync;
+
+            // Horizontal
+            if(hsyncTrigger)
+            {
+                _hactiveCount = _horizontal.active;
+                _hactiveVideo = false;
+                _hblankCount  = blankCount(_horizontal);
+            }
+            else if(_hblankCount != 0)
+            {
+                _hblankCount--;
+            }
+            else if(_hactiveCount != 0)
+            {
+                _hactiveVideo = true;
+                _hactiveCount--;
+            }
+            else
+            {
+                _hactiveVideo = false;
+            }
+
+            // Vertical
+            if(vsyncTrigger)
+            {
+                _vactiveCount = _vertical.active;
+                _vactiveVideo = false;
+                _vblankCount  = blankCount(_vertical);
+                _pixelCount   = 0;
+            }
+            else if(hsyncTrigger)
+            {
+                if(_vblankCount != 0)
+                {
+                    _vblankCount--;
+                }
+                else if(_vactiveCount != 0)
+                {
+                    _vactiveVideo = true;
+                    _vactiveCount--;
+                }
+                else
+                {
+                    _vactiveVideo = false;
+                }
+            }
+        }
+
+        void saveState(VerilatedSerialize& os);
+        void restoreState(VerilatedDeserialize& os);
+    };
+}
+}
+
+#endif
@@ -0,0 +1,221 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    VGA pixel conversion                                         //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#include "vgaPixelConverter.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VGA_PIXEL_CONVERTER_X86
+#include <immintrin.h>
+#endif
+
+namespace RoaLogic
+{
+namespace vdb
+{
+    /**
+     * @brief Scalar conversion, used for the remaining pixels of the vector implementations
+     */
+    static void convertScalar(const uRGBValue* source, uint8_t* destination, size_t numPixels)
+    {
+        for(size_t i = 0; i < numPixels; i++)
+        {
+            destination[0] = source[i].red;
+            destination[1] = source[i].green;
+            destination[2] = source[i].blue;
+            destination += 3;
+        }
+    }
+
+#ifdef VGA_PIXEL_CONVERTER_X86
+    /**
+     * @brief SSSE3 conversion
+     * @details Converts 16 pixels per iteration. Each group of 4 pixels is 
+     * shuffled into 12 RGB bytes, the 4 groups are combined into 3 stores.
+     */
+    __attribute__((target("ssse3")))
+    static void convertSSSE3(const uRGBValue* source, uint8_t* destination, size_t numPixels)
+    {
+        const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+        size_t i = 0;
+
+        for(; i + 16 <= numPixels; i += 16)
+        {
+            const __m128i* in = reinterpret_cast<const __m128i*>(source + i);
+            __m128i* out = reinterpret_cast<__m128i*>(destination + 3 * i);
+
+            __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(in + 0), shuffle);
+            __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(in + 1), shuffle);
+            __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(in + 2), shuffle);
+            __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(in + 3), shuffle);
+
+            _mm_storeu_si128(out + 0, _mm_or_si128(a, _mm_slli_si128(b, 12)));
+            _mm_storeu_si128(out + 1, _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+            _mm_storeu_si128(out + 2, _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+        }
+
+        convertScalar(source + i, destination + 3 * i, numPixels - i);
+    }
+
+    /**
+     * @brief AVX2 conversion
+     * @details Converts 32 pixels per iteration. The shuffle works per 128 bit
+     * lane, which gives 2 groups of 12 RGB bytes per register. These are 
+     * packed into 24 bytes with a permute, the 4 registers are then combined
+     * into 3 stores.
+     */
+    __attribute__((target("avx2")))
+    static void convertAVX2(const uRGBValue* source, uint8_t* destination, size_t numPixels)
+    {
+        const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+        const __m256i pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+        size_t i = 0;
+
+        for(; i + 32 <= numPixels; i += 32)
+        {
+            const __m256i* in = reinterpret_cast<const __m256i*>(source + i);
+            __m256i* out = reinterpret_cast<__m256i*>(destination + 3 * i);
+
+            // 24 RGB bytes in the low part of each register
+            __m256i a = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(in + 0), shuffle), pack);
+            __m256i b = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(in + 1), shuffle), pack);
+            __m256i c = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(in + 2), shuffle), pack);
+            __m256i d = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(in + 3), shuffle), pack);
+
+            // out0 = a[0..23] b[0..7], out1 = b[8..23] c[0..15], out2 = c[16..23] d[0..23]
+            __m256i out0 = _mm256_blend_epi32(a, _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, 1)), 0xc0);
+            __m256i out1 = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(2, 3, 4, 5, 0, 0, 0, 0)),
+                                              _mm256_permutevar8x32_epi32(c, _mm256_setr_epi32(0, 0, 0, 0, 0, 1, 2, 3)), 0xf0);
+            __m256i out2 = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(c, _mm256_setr_epi32(4, 5, 0, 0, 0, 0, 0, 0)),
+                                              _mm256_permutevar8x32_epi32(d, _mm256_setr_epi32(0, 0, 0, 1, 2, 3, 4, 5)), 0xfc);
+
+            _mm256_storeu_si256(out + 0, out0);
+            _mm256_storeu_si256(out + 1, out1);
+            _mm256_storeu_si256(out + 2, out2);
+        }
+
+        convertSSSE3(source + i, destination + 3 * i, numPixels - i);
+    }
+#endif
+
+    /**
+     * @brief Available implementations, the fastest last
+     */
+    static const cVgaPixelConverter::sImplementation cImplementations[] =
+    {
+        {"scalar", convertScalar},
+#ifdef VGA_PIXEL_CONVERTER_X86
+        {"SSSE3",  convertSSSE3},
+        {"AVX2",   convertAVX2},
+#endif
+    };
+
+    /**
+     * @brief Check if the CPU supports an implementation
+     */
+    static bool isSupported(const cVgaPixelConverter::sImplementation& implementation)
+    {
+#ifdef VGA_PIXEL_CONVERTER_X86
+        if(implementation.convert == convertSSSE3)
+        {
+            return __builtin_cpu_supports("ssse3");
+        }
+
+        if(implementation.convert == convertAVX2)
+        {
+            return __builtin_cpu_supports("avx2");
+        }
+#endif
+        return true;
+    }
+
+    /**
+     * @brief Get the implementations supported by the CPU
+     * 
+     * @param[out] implementations      The supported implementations, the fastest last
+     * @param[in]  maxImplementations   The size of implementations
+     * 
+     * @return The number of supported implementations
+     */
+    size_t cVgaPixelConverter::getImplementations(sImplementation* implementations, size_t maxImplementations)
+    {
+        size_t count = 0;
+
+        for(const sImplementation& implementation : cImplementations)
+        {
+            if(count < maxImplementations && isSupported(implementation))
+            {
+                implementations[count++] = implementation;
+            }
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Get the selected implementation
+     * @details The fastest supported implementation is selected on the first call
+     */
+    const cVgaPixelConverter::sImplementation& cVgaPixelConverter::selected()
+    {
+        static const sImplementation* implementation = []
+        {
+            const sImplementation* fastest = &cImplementations[0];
+
+            for(const sImplementation& candidate : cImplementations)
+            {
+                if(isSupported(candidate))
+                {
+                    fastest = &candidate;
+                }
+            }
+
+            return fastest;
+        }();
+
+        return *implementation;
+    }
+}
+}
@@ -0,0 +1,131 @@
+/////////////////////////////////////////////////////////////////////
+//   ,------.                    ,--.                ,--.          //
+//   |  .--. ' ,---.  ,--,--.    |  |    ,---. ,---. `--' ,---.    //
+//   |  '--'.'| .-. |' ,-.  |    |  |   | .-. | .-. |,--.| .--'    //
+//   |  |\  \ ' '-' '\ '-'  |    |  '--.' '-' ' '-' ||  |\ `--.    //
+//   `--' '--' `---'  `--`--'    `-----' `---' `-   /`--' `---'    //
+//                                             `---'               //
+//    VGA pixel conversion                                         //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+//                                                                 //
+//    Copyright (C) 2024 Roa Logic BV - www.roalogic.com           //
+//    Copyright (C) 2024 richard.herveille@roalogic.com            //
+//                                                                 //
+//     Redistribution and use in source and binary forms, with     //
+//   or without modification, are permitted provided that the      //
+//   following conditions are met:                                 //
+//   1. Redistributions of source code must retain the above       //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer.                                      //
+//   2. Redistributions in binary form must reproduce the above    //
+//      copyright notice, this list of conditions and the          //
+//      following disclaimer in the documentation and/or other     //
+//      materials provided with the distribution.                  //
+//   3. Neither the name of the copyright holder nor the names     //
+//      of its contributors may be used to endorse or promote      //
+//      products derived from this software without specific       //
+//      prior written permission.                                  //
+//                                                                 //
+//     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND      //
+//   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,   //
+//   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF      //
+//   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE      //
+//   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR         //
+//   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,  //
+//   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT  //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;  //
+//   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)      //
+//   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     //
+//   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE     //
+//   OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS       //
+//   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  //
+//                                                                 //
+/////////////////////////////////////////////////////////////////////
+
+#ifndef VGA_PIXEL_CONVERTER_HPP
+#define VGA_PIXEL_CONVERTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace RoaLogic
+{
+namespace vdb
+{
+    /**
+     * @brief A pixel of the VGA monitor
+     * @details B, G, R, A in memory, which is 0x00RRGGBB as integer
+     */
+    union uRGBValue
+    {
+        uint32_t asInt;
+        struct
+        {
+            uint8_t blue;
+            uint8_t green;
+            uint8_t red;
+            uint8_t alpha;
+        };
+    };
+
+    /**
+     * @class cVgaPixelConverter
+     * @brief Converts VGA pixels into packed RGB data
+     * @version 0.1
+     * @date 16-oct-2026
+     * 
+     * @details The VGA monitor stores a pixel as uRGBValue, which is B, G, R, A
+     * in memory. Image libraries, like wxImage::GetData(), use packed R, G, B 
+     * bytes. convert() converts a frame in one pass.
+     * 
+     * There is a scalar implementation and, on x86, an SSSE3 and an AVX2 
+     * implementation. The fastest implementation supported by the CPU is 
+     * selected at runtime, the first time it is used. The implementations
+     * are compiled with a target attribute, so the application doesn't have
+     * to be built for a specific instruction set.
+     * 
+     * The implementations are checked against the scalar one and benchmarked
+     * in the test directory.
+     */
+    class cVgaPixelConverter
+    {
+        public:
+        typedef void (*tConvertFunction)(const uRGBValue* source, uint8_t* destination, size_t numPixels);
+
+        /**
+         * @brief An implementation of the conversion
+         */
+        struct sImplementation
+        {
+            const char* name;           //!< Name of the instruction set
+            tConvertFunction convert;   //!< The conversion function
+        };
+
+        private:
+        static const sImplementation& selected();
+
+        public:
+        static size_t getImplementations(sImplementation* implementations, size_t maxImplementations);
+
+        /**
+         * @brief Convert pixels into packed RGB data
+         * 
+         * @param[in]  source       The pixels
+         * @param[out] destination  The RGB data, 3 bytes per pixel
+         * @param[in]  numPixels    The number of pixels to convert
+         */
+        static void convert(const uRGBValue* source, uint8_t* destination, size_t numPixels)
+        {
+            selected().convert(source, destination, numPixels);
+        }
+
+        /**
+         * @brief Get the name of the selected implementation
+         */
+        static const char* getName() { return selected().name; }
+    };
+}
+}
+
+#endif
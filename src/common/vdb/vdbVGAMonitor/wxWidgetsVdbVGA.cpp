@@ -66,8 +66,7 @@ namespace GUI {
         wxFrame(NULL, wxID_ANY, wxT("VGA monitor")),
         cGuiVDBComponent(myVDBComponent, position),
         _evtHandler(myEvtHandler),
-        _myImage(_cDefaultWidth, _cDefaultHeight, false),
-        _copySemaphore(1)
+        _myImage(_cDefaultWidth, _cDefaultHeight, false)
     {
         // Fill data array with dummy screen
         for (size_t i = 0; i < _cDefaultWidth; i++)
@@ -125,6 +124,9 @@ namespace GUI {
      */
     cWXVdbVGAMonitor::~cWXVdbVGAMonitor()
     {
+        INFO << "VGA monitor: " << _presented << " frames shown, " << _droppedRate << " dropped by the frame rate limit, "
+             << _droppedBusy << " dropped while the GUI was busy\n";
+
         delete _myStaticBitmap;
     }
 
@@ -144,6 +146,9 @@ namespace GUI {
      * 
      * Depending on the close state we either hide the panel or close it,
      * this is done by skipping the event and the default close is called.
+     * 
+     * A hidden panel doesn't show any frames, so it stops observing the
+     * VGA monitor, which then stops capturing the frames.
      */
     void cWXVdbVGAMonitor::closeEvt(wxCloseEvent& event)
     {
@@ -155,6 +160,7 @@ namespace GUI {
         else
         {
             Show(false);
+            removeObserver();
         }
     }
 
@@ -168,9 +174,11 @@ namespace GUI {
      * When the horizontalLines and verticalLines are 0 the image size
      * is still unknown
      * 
-     * First check that the image size is still the same as the data received,
-     * if this is not the case, resize the image. Following this copy the data 
-     * in the temporary buffer before secind the wxVGA_EVT
+     * A frame that comes in faster than the maximum frame rate, or while the 
+     * previous wxEVT_VGA isn't handled yet, is dropped without copying it.
+     * Otherwise the frame is copied into the back buffer, which is then 
+     * published before sending the wxEVT_VGA. The back buffer is owned by 
+     * this thread, so the copy never waits for the GUI.
      * 
      * @note this function runs in the verilated context.
      * 
@@ -179,27 +187,32 @@ namespace GUI {
      */
     void cWXVdbVGAMonitor::notify(eEvent aEvent, void* data)
     {
-        sVgaData* eventData = reinterpret_cast<sVgaData*>(data);
+        const sVgaData* eventData = &cVdbVGAMonitor::payload(data);
 
         if(aEvent == eEvent::vgaDataReady)
         {
             if(eventData->horizontalLines != 0 && eventData->verticalLines != 0)
             {
-                // Check if image is the same as current image, else resize the image
-                if( (_myImage.GetWidth()  != eventData->horizontalLines) || 
-                    (_myImage.GetHeight() != eventData->verticalLines))
+                tClock::time_point now = tClock::now();
+                double maxFrameRate = _maxFrameRate.load(std::memory_order_relaxed);
+
+                if(maxFrameRate > 0 && now - _lastPublished < std::chrono::duration<double>(1.0 / maxFrameRate))
                 {
-                    _myImage.Resize(wxSize(eventData->horizontalLines, eventData->verticalLines), wxDefaultPosition);
+                    _droppedRate.fetch_add(1, std::memory_order_relaxed);
+                    return;
                 }
 
-                // Copy the data from the buffer into our copy array and make sure that the copyarray is not accessed 
-                // during this time
-                _copySemaphore.acquire();
-                for (size_t y = 0; y < (_myImage.GetWidth() * _myImage.GetHeight()); y++)
+                if(_framePending.load(std::memory_order_acquire))
                 {
-                    _copyArray[y] = eventData->dataArray[y];
+                    _droppedBusy.fetch_add(1, std::memory_order_relaxed);
+                    return;
                 }
-                _copySemaphore.release();
+
+                // Copy the frame into the back buffer and hand it over to the GUI
+                _frames.back().copy(*eventData);
+                _frames.publish();
+                _lastPublished = now;
+                _framePending.store(true, std::memory_order_release);
 
                 // Data is ready now post the event to switch context
                 // Updating the UI element must happen in the UI context
@@ -213,32 +226,69 @@ namespace GUI {
      * @brief Handle the VGA event
      * @details This function handles the wxEVT_VGA event
      * 
-     * The event is sent when we need to update the image,
-     * data is in the copy buffer, which we now have to put
-     * into the wxImage. This is done here and at the end
-     * the image is placed inside the bitmap viewer.
+     * The event is sent when we need to update the image. The 
+     * newest published frame is taken from the triple buffer, and 
+     * converted into the wxImage data in one pass, see cVgaPixelConverter. 
+     * The image is resized first when the resolution changed. At the end the image is placed inside the bitmap viewer.
+     * When the frame of this event is already shown, nothing is done.
      * 
      * @note This function runs in the GUI thread
      * 
      */
     void cWXVdbVGAMonitor::onVGAEvent(wxCommandEvent& event)
     {
-        size_t currentOffset = 0;
+        // From here on a new frame can be published
+        _framePending.store(false, std::memory_order_release);
 
-        // Make sure we are not writing data into the array when we read it
-        _copySemaphore.acquire();
-        for (size_t y = 0; y < _myImage.GetHeight(); y++)
+        // Take the newest frame, the front buffer is owned by the GUI until the next acquire
+        if(!_frames.acquire())
         {
-            for (size_t x = 0; x < _myImage.GetWidth(); x++)
-            {
-                _myImage.SetRGB(x, y, _copyArray[currentOffset].red, _copyArray[currentOffset].green, _copyArray[currentOffset].blue);
-                currentOffset++;
-            }
+            return;
         }
-        _copySemaphore.release();
+
+        const sVgaFrame& frame = _frames.front();
+
+        // Check if image is the same as the frame, else resize the image
+        if( (_myImage.GetWidth()  != frame.width) || 
+            (_myImage.GetHeight() != frame.height))
+        {
+            _myImage.Resize(wxSize(frame.width, frame.height), wxDefaultPosition);
+        }
+
+        // Convert the pixels straight into the RGB data of the image
+        cVgaPixelConverter::convert(frame.pixels.data(), _myImage.GetData(), frame.pixels.size());
 
         // Update the bitmap and show the new image
         _myStaticBitmap->SetBitmap(_myImage);
+        _presented.fetch_add(1, std::memory_order_relaxed);
+
+        updateTitle();
+    }
+
+    /**
+     * @brief Show the frame rate in the title
+     * @details Once per second the title shows the resolution, the number 
+     * of shown frames per second and the number of dropped frames.
+     * 
+     * @note This function runs in the GUI thread
+     */
+    void cWXVdbVGAMonitor::updateTitle()
+    {
+        tClock::time_point now = tClock::now();
+        double seconds = std::chrono::duration<double>(now - _titleTime).count();
+
+        if(seconds >= 1.0)
+        {
+            uint64_t presented = _presented.load(std::memory_order_relaxed);
+
+            SetTitle(wxString::Format("VGA monitor %dx%d - %.1f fps, %llu dropped", 
+                                      _myImage.GetWidth(), _myImage.GetHeight(),
+                                      (presented - _titlePresented) / seconds,
+                                      static_cast<unsigned long long>(_droppedRate + _droppedBusy)));
+
+            _titleTime = now;
+            _titlePresented = presented;
+        }
     }
 
 }}
@@ -51,7 +51,11 @@
 
 #include "gui_interface.hpp"
 #include "vdbVGAMonitor.hpp"
-#include <semaphore>
+#include "tripleBuffer.hpp"
+#include "vgaPixelConverter.hpp"
+
+#include <atomic>
+#include <chrono>
 
 wxDECLARE_EVENT(wxEVT_VGA, wxCommandEvent);
 
@@ -69,10 +73,20 @@ namespace GUI {
      * class that wants to listen to it should register itself through
      * the subject-observer pattern.
      * 
-     * It receives the vgaDataReady event and copies the data into the
-     * _copyArray. By doing this the verilated context can continue and the 
-     * GUI thread can do the work of placing the data into a wxImage and show
-     * it on the screen. 
+     * It receives the vgaDataReady event and copies the frame into the back
+     * buffer of a triple buffer, which is then published. By doing this the 
+     * verilated context can continue and the GUI thread can do the work of 
+     * placing the newest frame into a wxImage and show it on the screen. 
+     * Neither thread waits for the other, when the GUI is slower than the 
+     * simulation the older frames are skipped.
+     * 
+     * The number of shown frames is limited to the maximum frame rate in 
+     * wall clock time, see setMaxFrameRate(), frames that come in faster are
+     * dropped before they are copied. At most one wxEVT_VGA is waiting in the
+     * event queue of wxWidgets. While it isn't handled the GUI is busy, and 
+     * the frames are dropped as well. The GUI always shows the newest 
+     * published frame. The frame rate and the number of dropped frames are 
+     * shown in the title of the window.
      * 
      * @attention The notify function runs in the verilated context, where
      * the onVGAEvent runs in the GUI context.
@@ -84,11 +98,24 @@ namespace GUI {
         static const size_t _cDefaultHeight = 480;  //!< Default image height to start with
         wxEvtHandler* _evtHandler;                  //!< The event handler of this frame
         wxStaticBitmap* _myStaticBitmap;            //!< Pointer to the handler for the bitmap
+        typedef std::chrono::steady_clock tClock;
+
+        static const uint32_t _cDefaultFrameRate = 60;  //!< Default maximum frame rate
+        static inline std::atomic<double> _maxFrameRate{_cDefaultFrameRate};   //!< Maximum shown frames per second, 0 is no limit
+
         wxImage _myImage;                           //!< Temporary image, used to create a new bitmap       
-        std::binary_semaphore _copySemaphore;       //!< Semaphore to protect the copy array
         bool close = false;
-        //!< Temporary array with the maximum size possible, used to copy data between threads.
-        uRGBValue _copyArray[cVdbVGAMonitor::cMaxVerticalLines * cVdbVGAMonitor::cMaxHorizontalLines];
+        cTripleBuffer<sVgaFrame> _frames;           //!< Frames passed from the verilated context to the GUI
+        std::atomic<bool> _framePending{false};     //!< A wxEVT_VGA is posted and not handled yet
+        tClock::time_point _lastPublished;          //!< Wall clock time of the last published frame, verilator thread
+
+        std::atomic<uint64_t> _presented{0};        //!< Number of shown frames
+        std::atomic<uint64_t> _droppedRate{0};      //!< Number of frames dropped by the frame rate limit
+        std::atomic<uint64_t> _droppedBusy{0};      //!< Number of frames dropped while the GUI was busy
+        tClock::time_point _titleTime;              //!< Wall clock time of the last title update, GUI thread
+        uint64_t _titlePresented = 0;               //!< Number of shown frames at the last title update
+
+        void updateTitle();
 
         void notify(eEvent aEvent, void* data);
         void onClose();
@@ -99,6 +126,13 @@ namespace GUI {
         public:
             cWXVdbVGAMonitor(cVDBCommon* myVDBComponent, distancePoint position, wxEvtHandler* myEvtHandler);
             ~cWXVdbVGAMonitor();
+
+            /**
+             * @brief Set the maximum frame rate of all VGA windows
+             * 
+             * @param[in] framesPerSecond   Maximum shown frames per second in wall clock time, 0 is no limit
+             */
+            static void setMaxFrameRate(double framesPerSecond) { _maxFrameRate = framesPerSecond; }
     };
 
 }}